@@ -6,10 +6,14 @@
 #include <signal.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
 #include <fcntl.h>
 #include <termios.h>
 #include <semaphore.h>
 #include <stdarg.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -19,10 +23,14 @@
 #include "../common/s4354198_defines.h"
 #include "../common/s4354198_utils.h"
 #include "../common/s4354198_externs.h"
+#include "../common/s4354198_barrier.h"
+#include "../common/s4354198_checkpoint.h"
 
 /* Function prototypes */
 void create_comms(void);
-void create_game(void);
+void create_game(const char* name);
+Game* find_universe(const char* name);
+void switch_universe(Game* game);
 void create_threads(void);
 void create_semaphores(void);
 void lock_print_to_shell(const char* format, ...);
@@ -30,37 +38,135 @@ void lock_print_to_display(const char* format, ...);
 void *shell_out_handler(void* voidPtr);
 void handle_input(char* input);
 void handle_new_life_form(char* input);
+void handle_new_batch(char* input);
+void handle_pattern(char* input);
+void free_life_form(LifeForm* lifeForm);
+void create_forms(void);
 void *display_out_handler(void* voidPtr);
+void *frame_out_handler(void* voidPtr);
 void run_game_logic(void);
-void copy_new_state_to_old(void);
+void tick_universe(void);
+void lock_game(void);
+void give_way(void);
+void swap_states(void);
+void wrap_edges(void);
 void send_to_display(void);
-void add_new_life_forms(void);
-void check_for_recently_dead(void);
-void *row_logic(void* voidPtr);
-void draw_coords(int** state, int id, ...);
-bool safe_coords(int y, int x);
-int count_neighbours(int row, int i);
-int highest_neighbour(int row, int i);
+void capture_snapshot(Snapshot* snapshot);
+bool add_new_life_forms(void);
+void report_dead(void);
+int compact_id(int realId);
+int renumber_ids(int realId);
+void send_ids_to_shell(const char* command, int* ids, int count);
+void real_ids(int* ids, int count);
+void step_universe(void);
+void step_generation(void);
+void observe_cycle(void);
+void resume_cycle(void);
+void handle_idle(char* input);
+void handle_ff(char* input);
+bool fast_forward(unsigned long steps);
+void handle_rewind(char* input);
+bool rewind_to(unsigned long generation);
+void restore_history(int index);
+void handle_checkpoint(char* input);
+void handle_restore(char* input);
+bool restore_checkpoint(Checkpoint* checkpoint, Rule* rule);
+void restore_life_forms(Checkpoint* checkpoint);
+void count_cells(const CellId* cells, int length);
+void empty_board(void);
+int* living_ids(int* count);
+void report_missing(int* ids, int count);
+void record_history(bool stepped);
+void record_board(bool stepped);
+void record_changes(void);
+void record_span(const CellId* previous, const CellId* current, int x, int y, int length);
+void send_history_stats(void);
+void send_cycle_stats(void);
+void send_tick_stats(void);
+uint64_t tile_signature(Grid* grid, int rowStart, int rowEnd, int xStart, int xEnd);
+void *band_logic(void* voidPtr);
+bool tile_logic(Worker* worker, Buffers* buffers, int tileRow, int tileCol);
+int census_span(Grid* previous, Grid* current, int row, int xStart, int xEnd, int slot);
+void step_tiles(Worker* worker, int tileRowStart, int tileRowEnd);
+bool deal_tiles(void);
+int tile_cost(int tile);
+void take_tiles(Worker* worker);
+int next_tile(Worker* worker);
+void step_tile(Worker* worker, int tile);
+unsigned long stolen_tiles(void);
+bool wavefront_ready(unsigned long steps);
+void wavefront_steps(unsigned long steps);
+void wavefront_band(Worker* worker);
+void wait_for_band(int index, int generation);
+void record_keyframe(void);
+bool temporal_ready(unsigned long steps);
+void temporal_steps(unsigned long steps);
+void block_tile(Worker* worker, int tile);
+void create_scratch(Grid** scratch);
+void sparse_logic(Worker* worker, int start, int end);
+void handle_view(char* input);
+void handle_rule(char* input);
+void apply_rule(void);
+void bits_span_ids(Buffers* buffers, int row, int xStart, int xEnd);
+void send_stats(void);
+void stamp_pattern(Grid* state, int id, Pattern* pattern, int y, int x);
+void draw_run(Grid* state, int id, int y, int x, int length);
+void set_cell(Grid* state, int y, int x, CellId id);
+CellId highest_neighbour(Grid* grid, int row, int i);
 void clear_states(void);
+void check_shards(bool ok);
+int run_bench(void);
+Pattern* bench_seed(void);
+bool bench_child(EngineType engine, const char* kernel, int depth, BenchResult* result);
+void bench_engine(EngineType engine, const char* kernel, int depth, BenchResult* result);
+void bench_depths(BenchResult* baseline);
+void bench_signature(BenchResult* result);
+void create_headless_comms(void);
+double bench_clock(void);
+void print_bench_result(BenchResult* result, bool matches);
+void print_json_string(const char* text);
 
 /* Globals */
 // Contains application data
 Application* app;
+// Every universe hosted, the default one first. Only changed by the shell
+// thread while it holds the game lock.
+Game** universes = NULL;
+int universeCount = 0;
+// Universe this thread is working on, whose tag goes on what it sends
+__thread Game* universe = NULL;
+// Universe whose snapshot was last handed to the frame thread
+Game* framing = NULL;
+// Rule every new universe starts with
+Rule startRule;
 // Semaphore for controlling the game loop
 sem_t runGame;
+// Threads other than the game loop waiting for runGame
+int gameWaiters = 0;
 // Semaphore for output back to the shell
 sem_t sendToShell;
 // Semaphore for output to the display
 sem_t sendToDisplay;
-// Semaphore to control when new life is added
-sem_t addLifeForm;
-// Semaphores to control the running of threads
-sem_t runThreads;
-sem_t finishedThreads;
+// Barriers to start and finish a generation across the worker pool
+Barrier startGeneration;
+Barrier finishGeneration;
 // Thread for the shell output
 pthread_t shellOutput;
 // Thread for the display output
 pthread_t displayOutput;
+// Thread building and writing frames from the snapshot
+pthread_t frameOutput;
+// Semaphores handing the snapshot between the game loop and frame thread
+sem_t snapshotReady;
+sem_t snapshotFree;
+// Cells of each built in form
+Pattern* forms[IMPORTED];
+// Row kernels compared by the benchmark, narrowest first
+const char* benchKernels[] = {"scalar", "sse2", "avx2"};
+// Temporal block depths tried by the benchmark, 1 being no blocking
+int benchDepths[] = {1, 2, 4, 8, 16};
+// Board every benchmark starts from
+Pattern* benchStart = NULL;
 
 int main(int argc, char** argv) {
     app = (Application*) malloc(sizeof(Application));
@@ -68,11 +174,20 @@ int main(int argc, char** argv) {
 
     s4354198_read_args(argc, argv);
 
+    // Benchmarks run on their own, without the shell, display or recorder
+    if (app->shellArgs->benchGenerations > 0) {
+        return run_bench();
+    }
+
     create_comms();
 
     create_semaphores();
 
-    create_game();
+    startRule = app->shellArgs->rule;
+    universes = (Game**) malloc(sizeof(Game*) * UNIVERSE_MAX);
+    create_game(UNIVERSE_DEFAULT);
+    universes[universeCount++] = app->game;
+    universe = app->game;
 
     create_threads();
 
@@ -108,34 +223,209 @@ void create_comms(void) {
 }
 
 /**
- * Creates the game related structs
+ * Creates the game related structs for a universe, sharing the worker 
+ * pool with any there already are
  */
-void create_game(void) {
+void create_game(const char* name) {
     app->game = (Game*) malloc(sizeof(Game));
+    strncpy(app->game->name, name, UNIVERSE_NAME_LENGTH);
+    app->game->name[UNIVERSE_NAME_LENGTH] = '\0';
+    app->game->tag[0] = '\0';
+    if (universeCount > 0) {
+        sprintf(app->game->tag, "%c%s ", UNIVERSE_TAG, app->game->name);
+    }
     app->game->paused = true;
-    app->game->newLifeForms = NULL;
+    app->game->newLifeForms = s4354198_queue_create();
+    if (app->game->newLifeForms == NULL) {
+        s4354198_exit(1, "Unable to allocate the lifeform queue\n");
+    }
+    app->game->generation = 0;
+
+    app->game->frame = s4354198_frame_writer_create();
+    app->game->snapshot = s4354198_snapshot_create(app->shellArgs->width, 
+        app->shellArgs->height);
+    if (app->game->snapshot == NULL) {
+        s4354198_exit(1, "Unable to allocate the frame snapshot\n");
+    }
+    app->game->oldState = NULL;
+    app->game->newState = NULL;
+    app->game->oldBits = NULL;
+    app->game->newBits = NULL;
+    app->game->activity = NULL;
+    app->game->life = NULL;
+    app->game->world = NULL;
+    app->game->shards = NULL;
+    app->game->cycle = s4354198_cycle_create();
+    // Sharded boards are never all in one place to be recorded
+    app->game->history = (app->shellArgs->historyMegabytes > 0 && 
+            app->shellArgs->shards <= 1) ? 
+        s4354198_history_create((size_t) app->shellArgs->historyMegabytes * 1024 * 1024) :
+        NULL;
+    app->game->ticker = s4354198_ticker_create(app->shellArgs->refreshRate, MIN_REFRESH);
+    app->game->viewX = 0;
+    app->game->viewY = 0;
+
+    if (universeCount == 0) {
+        create_forms();
+    }
+
+    // One worker per core, each owning a contiguous band of tile rows
+    int workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) {
+        workers = 1;
+    }
+
+    if (app->shellArgs->shards > 1) {
+        // Each strip is stepped by its own process, started before any 
+        // threads so there are none to lose in the fork. Never more 
+        // shards than rows.
+        int shards = (app->shellArgs->shards < app->shellArgs->height) ? 
+            app->shellArgs->shards : app->shellArgs->height;
+
+        app->game->shards = s4354198_shards_create(app->shellArgs->width, 
+            app->shellArgs->height, shards);
+        if (app->game->shards == NULL) {
+            s4354198_exit(1, "Unable to start the shards\n");
+        }
+        workers = 0;
+    } else if (app->shellArgs->engine == ENGINE_HASHLIFE) {
+        // Hashlife steps its own unbounded universe on the game loop, and 
+        // the board is just a window onto it
+        app->game->life = s4354198_hashlife_create(HASHLIFE_DEFAULT_NODES);
+        workers = 0;
+    } else if (app->shellArgs->engine == ENGINE_SPARSE) {
+        // Tiles are shared out between the workers every generation
+        app->game->world = s4354198_sparse_create();
+    } else {
+        // The old state always holds the current generation once a tick is done
+        app->game->oldState = s4354198_grid_create(app->shellArgs->width, 
+            app->shellArgs->height);
+        app->game->newState = s4354198_grid_create(app->shellArgs->width, 
+            app->shellArgs->height);
+        app->game->activity = s4354198_activity_create(app->shellArgs->width, 
+            app->shellArgs->height, app->shellArgs->torus);
+
+        if (workers > app->game->activity->tileRows) {
+            workers = app->game->activity->tileRows;
+        }
+    }
+
+    // The bit engine keeps liveness packed separately from the id planes
+    if (app->shellArgs->engine == ENGINE_BITS) {
+        app->game->oldBits = s4354198_bitgrid_create(app->shellArgs->width, 
+            app->shellArgs->height);
+        app->game->newBits = s4354198_bitgrid_create(app->shellArgs->width, 
+            app->shellArgs->height);
+    }
+
+    apply_rule();
+
+    // Each worker records census changes in its own slot, the last
+    // slot is used by the game loop when drawing
+    app->game->census = s4354198_census_create(workers + 1);
+    app->game->ids = s4354198_idmap_create();
+
+    app->game->waveGenerations = 0;
+    app->game->blockGenerations = 0;
+    app->game->scratch[0] = NULL;
+    app->game->scratch[1] = NULL;
+    if (app->shellArgs->temporalDepth > 1 && app->game->activity != NULL) {
+        create_scratch(app->game->scratch);
+    }
+
+    // Every universe is the same size, so the first one's bands suit them all
+    if (universeCount > 0) {
+        app->game->workers = universes[0]->workers;
+        app->game->workerCount = universes[0]->workerCount;
+        return;
+    }
 
-    app->game->oldState = (int**) malloc(sizeof(int*) * app->shellArgs->height);
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        app->game->oldState[i] = (int*) malloc(sizeof(int) * app->shellArgs->width);
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            app->game->oldState[i][j] = 0;
+    // Workers plus the game loop itself
+    s4354198_barrier_init(&startGeneration, workers + 1);
+    s4354198_barrier_init(&finishGeneration, workers + 1);
+
+    app->game->workerCount = workers;
+    app->game->workers = (Worker*) malloc(sizeof(Worker) * workers);
+    for (int i = 0; i < workers; i++) {
+        Worker* worker = &(app->game->workers[i]);
+        worker->index = i;
+        worker->rowStart = 0;
+        worker->rowEnd = 0;
+        worker->done = 0;
+        worker->steals = 0;
+        worker->scratch[0] = NULL;
+        worker->scratch[1] = NULL;
+        // Sparse tiles come and go, so their deques grow as they are dealt
+        worker->tiles = s4354198_deque_create((app->game->activity != NULL) ?
+            app->game->activity->tileRows * app->game->activity->tileCols : 0);
+        if (app->game->activity != NULL) {
+            int tileRows = app->game->activity->tileRows;
+            worker->rowStart = ((tileRows * i) / workers) * ACTIVITY_TILE_ROWS;
+            worker->rowEnd = ((tileRows * (i + 1)) / workers) * ACTIVITY_TILE_ROWS;
+            if (worker->rowEnd > app->shellArgs->height) {
+                worker->rowEnd = app->shellArgs->height;
+            }
+        }
+        if (app->shellArgs->temporalDepth > 1 && app->game->activity != NULL) {
+            create_scratch(worker->scratch);
         }
+        pthread_create(&(worker->thread), NULL, &band_logic, (void*) worker);
+    }
+}
+
+/**
+ * Creates a pair of scratch grids big enough for a tile and the deepest 
+ * halo temporal blocking can need
+ */
+void create_scratch(Grid** scratch) {
+    for (int i = 0; i < 2; i++) {
+        scratch[i] = s4354198_grid_create(ACTIVITY_TILE_COLS + 2 * TEMPORAL_MAX_DEPTH,
+            ACTIVITY_TILE_ROWS + 2 * TEMPORAL_MAX_DEPTH);
     }
+}
 
-    app->game->newState = (int**) malloc(sizeof(int*) * app->shellArgs->height);
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        app->game->newState[i] = (int*) malloc(sizeof(int) * app->shellArgs->width);
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            app->game->newState[i][j] = 0;
+/**
+ * Gets a universe by name, making it the first time it is named. Only 
+ * called from the shell thread. Returns NULL if the name is not valid or 
+ * there is no room for another.
+ */
+Game* find_universe(const char* name) {
+    for (int i = 0; i < universeCount; i++) {
+        if (strcmp(universes[i]->name, name) == 0) {
+            return universes[i];
         }
     }
 
-    app->game->threads = (pthread_t*) malloc(sizeof(pthread_t) * app->shellArgs->height);
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        int* arg = (int*) malloc(sizeof(int));
-        *arg = i;
-        pthread_create(&(app->game->threads[i]), NULL, &row_logic, (void*) arg);
+    if (universeCount == UNIVERSE_MAX || !s4354198_valid_universe_name(name)) {
+        return NULL;
+    }
+
+    // New universes start from the rule given to cag, not the last one used
+    lock_game();
+    app->shellArgs->rule = startRule;
+    create_game(name);
+    universes[universeCount] = app->game;
+    // The game loop reads the count without the lock
+    __atomic_store_n(&universeCount, universeCount + 1, __ATOMIC_RELEASE);
+    sem_post(&runGame);
+
+    return universes[universeCount - 1];
+}
+
+/**
+ * Makes a universe the one the game lock holder and this thread work on.
+ * The kernels only hold one rule, so it is handed over if it differs.
+ */
+void switch_universe(Game* game) {
+    Rule* rule = &(app->shellArgs->rule);
+
+    universe = game;
+    app->game = game;
+
+    if (game->rule.birth != rule->birth || game->rule.survive != rule->survive) {
+        *rule = game->rule;
+        s4354198_grid_set_rule(rule);
+        s4354198_bitgrid_set_rule(rule);
     }
 }
 
@@ -145,6 +435,7 @@ void create_game(void) {
 void create_threads(void) {
     pthread_create(&shellOutput, NULL, &shell_out_handler, NULL);
     pthread_create(&displayOutput, NULL, &display_out_handler, NULL);
+    pthread_create(&frameOutput, NULL, &frame_out_handler, NULL);
 }
 
 /**
@@ -154,9 +445,8 @@ void create_semaphores(void) {
     sem_init(&runGame, 0, 1);
     sem_init(&sendToShell, 0, 1);
     sem_init(&sendToDisplay, 0, 1);
-    sem_init(&addLifeForm, 0, 1);
-    sem_init(&runThreads, 0, 0);
-    sem_init(&finishedThreads, 0, 0);
+    sem_init(&snapshotReady, 0, 0);
+    sem_init(&snapshotFree, 0, 1);
 }
 
 /**
@@ -167,6 +457,9 @@ void lock_print_to_shell(const char *format, ...) {
     va_start(args, format);
 
     sem_wait(&sendToShell);
+    if (universe != NULL) {
+        fputs(universe->tag, app->comms->toShell);
+    }
     vfprintf(app->comms->toShell, format, args);
     fflush(app->comms->toShell);
     sem_post(&sendToShell);
@@ -234,6 +527,27 @@ void handle_input(char* input) {
     char original[inputLength];
     strncpy(original, input, inputLength);
 
+    // Untagged commands are for the default universe
+    universe = universes[0];
+    if (input[0] == UNIVERSE_TAG) {
+        token = strsep(&input, " ");
+
+        // Shards are forked once, before there are any threads to lose
+        if (app->shellArgs->shards > 1 && strcmp(token + 1, universes[0]->name) != 0) {
+            lock_print_to_shell("Other universes need the whole board in this process,"
+                " start without -N\n");
+            return;
+        }
+
+        Game* game = find_universe(token + 1);
+
+        if (game == NULL) {
+            lock_print_to_shell("No such universe and no room for it (%s)\n", token + 1);
+            return;
+        }
+        universe = game;
+    }
+
     token = strsep(&input, " ");
     
     // NULL token indicates it was an empty string
@@ -243,27 +557,52 @@ void handle_input(char* input) {
 
     if (s4354198_str_match(token, COMMS_NEW)) {
         handle_new_life_form(input);
+    } else if (s4354198_str_match(token, COMMS_NEWBATCH)) {
+        handle_new_batch(input);
+    } else if (s4354198_str_match(token, COMMS_PATTERN)) {
+        handle_pattern(input);
     } else if (s4354198_str_match(token, COMMS_STOP)) {
-        sem_wait(&runGame);
+        lock_game();
         app->game->paused = true;
         sem_post(&runGame);
     } else if (s4354198_str_match(token, COMMS_START)) {
-        sem_wait(&runGame);
+        lock_game();
         app->game->paused = false;
         sem_post(&runGame);
     } else if (s4354198_str_match(token, COMMS_CLEAR)) {
-        sem_wait(&runGame);
+        lock_game();
         clear_states();
         sem_post(&runGame);
     } else if (s4354198_str_match(token, CMD_STOP_OUTPUT)) {
-        sem_wait(&runGame);
+        lock_game();
         app->game->paused = true;
         app->silence = true;
         sem_post(&runGame);
     } else if (s4354198_str_match(token, CMD_START_OUTPUT)) {
-        sem_wait(&runGame);
+        lock_game();
         app->silence = false;
         sem_post(&runGame);
+    } else if (s4354198_str_match(token, COMMS_STATS)) {
+        lock_game();
+        send_stats();
+        send_cycle_stats();
+        send_history_stats();
+        send_tick_stats();
+        sem_post(&runGame);
+    } else if (s4354198_str_match(token, COMMS_IDLE)) {
+        handle_idle(input);
+    } else if (s4354198_str_match(token, COMMS_FF)) {
+        handle_ff(input);
+    } else if (s4354198_str_match(token, COMMS_REWIND)) {
+        handle_rewind(input);
+    } else if (s4354198_str_match(token, COMMS_CHECKPOINT)) {
+        handle_checkpoint(input);
+    } else if (s4354198_str_match(token, COMMS_RESTORE)) {
+        handle_restore(input);
+    } else if (s4354198_str_match(token, COMMS_VIEW)) {
+        handle_view(input);
+    } else if (s4354198_str_match(token, COMMS_RULE)) {
+        handle_rule(input);
     } else {
         error = true;
     }
@@ -274,460 +613,2702 @@ void handle_input(char* input) {
 }
 
 /**
- * Handles the creation of a new lifeform
+ * Moves the window the board shows onto an unbounded universe
  */
-void handle_new_life_form(char* input) {
-    int id = -1;
-    LifeType lifeType = CELL;
-    FormType formType = ALIVE;
-    int x = 0;
-    int y = 0;
-    char* token;
+void handle_view(char* input) {
     char* endToken;
+    char* yToken;
+    long x = 0;
+    long y = 0;
+    bool valid = (input != NULL);
+
+    // The y coordinate may be left off, as the view then sits on the x axis
+    if (valid) {
+        x = strtol(input, &endToken, 10);
+        valid = (endToken != input && (*endToken == '\0' || *endToken == ' '));
+    }
+    if (valid && *endToken == ' ') {
+        yToken = endToken + 1;
+        y = strtol(yToken, &endToken, 10);
+        valid = (endToken != yToken && *endToken == '\0');
+    }
+    if (!valid || x < INT_MIN || x > INT_MAX || y < INT_MIN || y > INT_MAX) {
+        lock_print_to_shell("Invalid view (%s)\n", input == NULL ? "" : input);
+        return;
+    }
 
-    for (int i = 0; i < 5; i++) {
-        token = strsep(&input, " ");
-
-        switch (i) {
-            case 0:
-                id = strtol(token, &endToken, 10);
-                break;
-            case 1:
-                lifeType = (LifeType) strtol(token, &endToken, 10);
-                break;
-            case 2:
-                formType = (FormType) strtol(token, &endToken, 10);
-                break;
-            case 3:
-                x = strtol(token, &endToken, 10);
-                break;
-            case 4:
-                y = strtol(token, &endToken, 10);
-                break;
-        }
+    if (universe->life == NULL && universe->world == NULL) {
+        lock_print_to_shell("The %s engine has a fixed board, use the %s or %s engine"
+            " to move the view\n", s4354198_engine_name(app->shellArgs->engine),
+            ENGINE_NAME_HASHLIFE, ENGINE_NAME_SPARSE);
+        return;
     }
 
-    sem_wait(&addLifeForm);
+    lock_game();
+    resume_cycle();
+    app->game->viewX = (int) x;
+    app->game->viewY = (int) y;
+    sem_post(&runGame);
+}
 
-    LifeForm *new = (LifeForm*) malloc(sizeof(LifeForm));
-    new->id = id;
-    new->x = x;
-    new->y = y;
-    new->lifeType = lifeType;
-    new->formType = formType;
-    new->next = NULL;
+/**
+ * Turns replaying settled boards from the cache on or off
+ */
+void handle_idle(char* input) {
+    bool allowed;
 
-    // Add lifeform to the directional linked list of new lifeforms
-    if (app->game->newLifeForms == NULL) {
-        app->game->newLifeForms = new;
+    if (input != NULL && s4354198_str_match(input, COMMS_ON)) {
+        allowed = true;
+    } else if (input != NULL && s4354198_str_match(input, COMMS_OFF)) {
+        allowed = false;
     } else {
-        LifeForm *last = app->game->newLifeForms;
-        while (last->next != NULL) {
-            last = last->next;
-        }
-        last->next = new;
+        lock_print_to_shell("Invalid idle setting (%s)\n", input == NULL ? "" : input);
+        return;
     }
 
-    sem_post(&addLifeForm);
+    lock_game();
+    if (!allowed) {
+        resume_cycle();
+    }
+    app->game->cycle->idleAllowed = allowed;
+    sem_post(&runGame);
 }
 
 /**
- * Checks if a pair of coordinates are safe
+ * Computes a number of generations back to back, with no sleeping and no
+ * frames until the last one
  */
-bool safe_coords(int y, int x) {
-    return (y >= 0 && y < app->shellArgs->height && x >= 0 && x < app->shellArgs->width);
-}
+void handle_ff(char* input) {
+    char* endToken;
+    unsigned long generations = (input == NULL) ? 0 : strtoul(input, &endToken, 10);
+    struct timespec start;
+    struct timespec end;
 
-/**
- * Sets all the pairs of the coorindates in the specified state
- */
-void draw_coords(int** state, int id, ...) {
-    va_list args;
-    va_start(args, id);
-    int arg1;
-    int arg2;
+    if (generations == 0) {
+        lock_print_to_shell("Invalid number of generations (%s)\n", 
+            input == NULL ? "" : input);
+        return;
+    }
 
-    while((arg1 = va_arg(args, int)) != -1 && (arg2 = va_arg(args, int)) != -1) {
-        if (safe_coords(arg1, arg2)) {
-            state[arg1][arg2] = id;
-        }
+    lock_game();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // A settled board only needs to go round its cycle the remainder
+    Cycle* cycle = app->game->cycle;
+    unsigned long period = s4354198_cycle_settled(cycle) ? cycle->period : 0;
+    unsigned long target = app->game->generation + generations;
+
+    resume_cycle();
+    if (fast_forward((period != 0) ? generations % period : generations)) {
+        app->game->generation = target;
     }
+    record_history(false);
 
-    va_end(args);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    lock_print_to_shell("Generation %lu reached in %.1fms\n", app->game->generation,
+        (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6);
+
+    if (!app->silence) {
+        send_to_display();
+    }
+    sem_post(&runGame);
 }
 
 /**
- * Adds new lifeforms to the game state
+ * Steps the engine the given number of generations, reporting deaths as
+ * they happen. Hashlife takes the biggest power of two jumps it can.
+ * Returns false if the universe grew too big to get there.
  */
-void add_new_life_forms(void) {
-    sem_wait(&addLifeForm);
-
-    LifeForm *lifeForm;
-    int** state = app->game->newState;
-
-    // Iterate through all life forms and add them
-    while ((lifeForm = app->game->newLifeForms) != NULL) {
-        int id = lifeForm->id;
-        int x = lifeForm->x;
-        int y = lifeForm->y;
+bool fast_forward(unsigned long steps) {
+    if (app->game->life != NULL) {
+        for (int bit = 63; bit >= 0; bit--) {
+            if (((steps >> bit) & 1) && !s4354198_hashlife_step(app->game->life, bit)) {
+                app->game->paused = true;
+                lock_print_to_shell("The universe has grown too big to step, stopping\n");
+                return false;
+            }
+        }
+        report_dead();
+        return true;
+    }
 
-        // Change to 0 indexing
-        x--;
-        y--;
+    // The shards step on their own without hearing from the game loop
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_step(app->game->shards, steps));
+        app->game->generation += steps;
+        report_dead();
+        return true;
+    }
 
-        switch (lifeForm->formType) {
-            case ALIVE:
-                draw_coords(state, id, y, x, -1);
-                break;
-            case DEAD:
-                draw_coords(state, id, y, x, -1);
-                break;
-            case BLOCK:
-                draw_coords(state, id, y, x, y, x+1, y+1, x, y+1, x+1, -1);
-                break;
-            case BEEHIVE:
-                draw_coords(state, id, y, x+1, y, x+2, y+1, x, y+1, x+3, y+2, x+1, y+2, x+2, -1);
-                break;
-            case LOAF:
-                draw_coords(state, id, y, x+1, y, x+2, y+1, x, y+1, x+3, y+2, x+1, y+2, x+3, y+3, x+2, -1);
-                break;
-            case BOAT:
-                draw_coords(state, id, y, x, y, x+1, y+1, x, y+1, x+2, y+2, x+1, -1);
-                break;
-            case BLINKER:
-                draw_coords(state, id, y, x, y+1, x, y+2, x, -1);
-                break;
-            case TOAD:
-                draw_coords(state, id, y, x+1, y, x+2, y, x+3, y+1, x, y+1, x+1, y+1, x+2, -1);
-                break;
-            case BEACON:
-                draw_coords(state, id, y, x, y, x+1, y+1, x, y+2, x+3, y+3, x+2, y+3, x+3, -1);
-                break;
-            case GLIDER:
-                draw_coords(state, id, y, x, y, x+2, y+1, x+1, y+1, x+2, y+2, x+1, -1);
-                break;
-        }
+    if (temporal_ready(steps)) {
+        temporal_steps(steps);
+        return true;
+    }
 
-        app->game->newLifeForms = lifeForm->next;
-        free(lifeForm);
+    if (wavefront_ready(steps)) {
+        wavefront_steps(steps);
+        return true;
     }
 
-    check_for_recently_dead();
+    for (unsigned long i = 0; i < steps; i++) {
+        step_generation();
+        report_dead();
+    }
 
-    sem_post(&addLifeForm);
+    return true;
 }
 
 /**
- * Checks for ids that are no longer present
+ * Takes the board back a number of generations using the history
  */
-void check_for_recently_dead(void) {
-    int cells = app->shellArgs->height * app->shellArgs->width;
-    int index = 0;
-    int oldIds[cells];
-    int currentIds[cells];
-    int removed[cells];
+void handle_rewind(char* input) {
+    char* endToken;
+    unsigned long generations = (input == NULL) ? 0 : strtoul(input, &endToken, 10);
+    struct timespec start;
+    struct timespec end;
 
-    // Get list of prev state ids
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            int id = app->game->oldState[i][j];
-            oldIds[index++] = id;
-        }
+    if (generations == 0) {
+        lock_print_to_shell("Invalid number of generations (%s)\n", 
+            input == NULL ? "" : input);
+        return;
     }
 
-    // Get list of current state ids
-    index = 0;
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            int id = app->game->newState[i][j];
-            currentIds[index++] = id;
-        }
+    if (universe->shards != NULL) {
+        lock_print_to_shell("Rewinding needs the whole board in this process, start"
+            " without -N\n");
+        return;
     }
 
-    // Find the missing ones
-    index = 0;
-    for (int i = 0; i < cells; i++) {
-        int oldId = oldIds[i];
+    if (universe->history == NULL) {
+        lock_print_to_shell("History is turned off, start with -H to keep some\n");
+        return;
+    }
 
-        bool found = false;
-        for (int j = 0; j < cells; j++) {
-            int currentId = currentIds[j];
+    lock_game();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    resume_cycle();
 
-            if (currentId == oldId) {
-                found = true;
-                break;
-            }
-        }
+    if (generations > app->game->generation) {
+        lock_print_to_shell("Only %lu generations have gone by\n", app->game->generation);
+    } else if (!rewind_to(app->game->generation - generations)) {
+        lock_print_to_shell("Generation %lu is no longer kept\n", 
+            app->game->generation - generations);
+    } else {
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        lock_print_to_shell("Rewound to generation %lu in %.1fms\n", app->game->generation,
+            (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1e6);
 
-        if (!found) {
-            removed[index++] = oldId;
+        if (!app->silence) {
+            send_to_display();
         }
     }
 
-    // Notify the shell about the dead ids
-    for (int i = 0; i < index; i++) {
-        if (removed[i] != 0) {
-            lock_print_to_shell("%s %d\n", COMMS_DEAD, removed[i]);
-        }
-    }
+    sem_post(&runGame);
 }
 
 /**
- * Handles output from the display
+ * Goes back to the newest kept generation at or before the one given and
+ * computes forward from there. Returns false if it is no longer kept.
  */
-void* display_out_handler(void* voidPtr) {
-    bool stop = false;
-    char* input = NULL;
-    char* cleanedInput = NULL;
-    size_t size;
-
-    while (!stop) {
-        int read = getline(&input, &size, app->comms->fromDisplay);
-        
-        if (read == -1) {
-            stop = true;
-        } else {
-            // Remove the newline from the end
-            cleanedInput = (char*) malloc(sizeof(char) * strlen(input));
-            strncpy(cleanedInput, input, strlen(input) - 1);
-            cleanedInput[strlen(input) - 1] = '\0';
+bool rewind_to(unsigned long generation) {
+    if (app->game->life != NULL) {
+        uint64_t found;
 
-            lock_print_to_shell("(Display) %s\n", cleanedInput);
+        if (!s4354198_hashlife_recall(app->game->life, generation, &found)) {
+            return false;
+        }
+        app->game->generation = found;
+    } else {
+        int index = s4354198_history_find(app->game->history, generation);
 
-            free(cleanedInput);
+        if (index < 0) {
+            return false;
         }
+        restore_history(index);
+        s4354198_history_truncate(app->game->history, index);
+        app->game->generation = app->game->history->entries[index].generation;
     }
 
-    return NULL;
+    // Replayed cycles and settled fast forwards leave gaps in the history
+    if (fast_forward(generation - app->game->generation)) {
+        app->game->generation = generation;
+    }
+    record_history(false);
+
+    return true;
 }
 
 /**
- * Sends the current game state to the display
+ * Rebuilds the board from a history entry, replaying from its keyframe.
+ * Lifeforms that were alive but are not in the rebuilt board are reported
+ * dead.
  */
-void send_to_display(void) {
-    char* messages[app->shellArgs->height];
-    int totalSize = 0;
+void restore_history(int index) {
+    History* history = app->game->history;
+    int count;
+    int* before = living_ids(&count);
 
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        int size = BUFFER_SIZE;
-        int index = 0;
-        char* message = (char*) malloc(sizeof(char) * size);
+    // Start again from an empty board, as a keyframe expects
+    empty_board();
 
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            index += sprintf(&message[index], "%d", app->game->newState[i][j]);
+    for (int i = s4354198_history_keyframe(history, index); i <= index; i++) {
+        HistoryEntry* entry = &(history->entries[i]);
 
-            if (j < app->shellArgs->width - 1) {
-                index += sprintf(&message[index], ",");
-            }
+        for (int j = 0; j < entry->count; j++) {
+            HistoryRun* run = &(entry->runs[j]);
+            int id = compact_id(run->id);
 
-            // Account for \n and \0
-            if (index == size - 2) {
-                size *= 2;
-                message = (char*) realloc(message, size);
+            for (int k = 0; k < run->length; k++) {
+                set_cell(app->game->oldState, run->y, run->x + k, id);
             }
         }
-
-        messages[i] = message;        
-        totalSize += strlen(message);
     }
+    s4354198_census_merge(app->game->census);
 
-    // Account for NUL terminator
-    totalSize++;
-    char finalMessage[totalSize + (app->shellArgs->height)];
-    int index = 0;
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        index += sprintf(&finalMessage[index], "%s", messages[i]);
+    report_missing(before, count);
+}
 
-        if (i < app->shellArgs->height - 1) {
-            index += sprintf(&finalMessage[index], ",");
-        }
+/**
+ * Writes the whole game to a checkpoint file
+ */
+void handle_checkpoint(char* input) {
+    struct timespec start;
+    struct timespec end;
+
+    if (input == NULL || strlen(input) == 0) {
+        lock_print_to_shell("No checkpoint file given\n");
+        return;
+    }
 
-        free(messages[i]);
+    if (universe->shards != NULL) {
+        lock_print_to_shell("Checkpoints need the whole board in this process, start"
+            " without -N\n");
+        return;
     }
 
-    lock_print_to_display("%s\n", finalMessage);
+    lock_game();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // The engine has to be holding the generation that is saved
+    resume_cycle();
+    // Imported patterns only live in memory, so anything waiting is drawn first
+    add_new_life_forms();
+    bool saved = s4354198_checkpoint_save(input, app->game, app->shellArgs);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (saved) {
+        lock_print_to_shell("Generation %lu saved to %s in %.1fms\n", app->game->generation,
+            input, (end.tv_sec - start.tv_sec) * 1000.0 + 
+            (end.tv_nsec - start.tv_nsec) / 1e6);
+    } else {
+        lock_print_to_shell("Could not save to %s (%s)\n", input, strerror(errno));
+    }
+    sem_post(&runGame);
 }
 
 /**
- * Clears all states
+ * Replaces the whole game with one from a checkpoint file, which has to
+ * have been written by an engine with the same layout
  */
-void clear_states(void) {
-    // Get list of current state ids
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            int id = app->game->newState[i][j];
-            lock_print_to_shell("%s %d\n", COMMS_DEAD, id);
-        }
+void handle_restore(char* input) {
+    const char* error;
+    char ruleName[RULE_NAME_LENGTH + 1];
+    Rule rule;
+    struct timespec start;
+    struct timespec end;
+
+    if (input == NULL || strlen(input) == 0) {
+        lock_print_to_shell("No checkpoint file given\n");
+        return;
     }
 
-    // Zero everything
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            app->game->oldState[i][j] = 0;
-            app->game->newState[i][j] = 0;
+    if (universe->shards != NULL) {
+        lock_print_to_shell("Checkpoints need the whole board in this process, start"
+            " without -N\n");
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Checkpoint* checkpoint = s4354198_checkpoint_open(input, &error);
+    if (checkpoint == NULL) {
+        lock_print_to_shell("Could not restore %s (%s)\n", input, error);
+        return;
+    }
+
+    CheckpointHeader* header = checkpoint->header;
+    CheckpointKind kind = s4354198_checkpoint_kind(app->shellArgs->engine);
+    memcpy(ruleName, header->rule, RULE_NAME_LENGTH);
+    ruleName[RULE_NAME_LENGTH] = '\0';
+
+    if (header->kind != kind) {
+        lock_print_to_shell("Could not restore %s (it holds a %s board, the %s engine "
+            "needs a %s one)\n", input, s4354198_checkpoint_kind_name(header->kind), 
+            s4354198_engine_name(app->shellArgs->engine), 
+            s4354198_checkpoint_kind_name(kind));
+    } else if (kind == CHECKPOINT_GRID && (header->width != app->shellArgs->width ||
+            header->height != app->shellArgs->height)) {
+        lock_print_to_shell("Could not restore %s (it holds a %dx%d board, this one is "
+            "%dx%d)\n", input, header->width, header->height, app->shellArgs->width,
+            app->shellArgs->height);
+    } else if (!s4354198_rule_parse(ruleName, &rule)) {
+        lock_print_to_shell("Could not restore %s (its rule is invalid)\n", input);
+    } else {
+        lock_game();
+        if (restore_checkpoint(checkpoint, &rule)) {
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            lock_print_to_shell("Generation %lu restored from %s in %.1fms\n", 
+                app->game->generation, input, (end.tv_sec - start.tv_sec) * 1000.0 + 
+                (end.tv_nsec - start.tv_nsec) / 1e6);
+
+            if (!app->silence) {
+                send_to_display();
+            }
+        } else {
+            lock_print_to_shell("Could not restore %s (its universe is corrupt)\n", input);
         }
+        sem_post(&runGame);
     }
+
+    s4354198_checkpoint_close(checkpoint);
 }
 
 /**
- * Runs the game logic
+ * Loads the engine, ids, rule and lifeforms waiting to be drawn from a
+ * checkpoint that has been checked to suit the engine. Returns false,
+ * leaving the game alone, if a hashlife universe turns out to be corrupt.
  */
-void run_game_logic(void) {
-    bool stop = false;
+bool restore_checkpoint(Checkpoint* checkpoint, Rule* rule) {
+    CheckpointHeader* header = checkpoint->header;
+    int count;
+    int* before = living_ids(&count);
+
+    if (app->game->life != NULL) {
+        Hashlife* life = app->game->life;
+
+        if (!s4354198_hashlife_load(life, (uint32_t*) checkpoint->planes, 
+                header->planeCount)) {
+            free(before);
+            return false;
+        }
+        for (int i = 0; i < header->idCount; i++) {
+            s4354198_hashlife_add_id(life, checkpoint->ids[i]);
+        }
+    } else {
+        empty_board();
+        for (int i = 1; i < header->idCount; i++) {
+            s4354198_idmap_append(app->game->ids, checkpoint->ids[i]);
+        }
+        s4354198_census_reserve(app->game->census, header->idCount - 1);
+    }
 
-    while (!stop) {
-        sem_wait(&runGame);
+    if (app->game->world != NULL) {
+        CheckpointTile* tiles = (CheckpointTile*) checkpoint->planes;
 
-        // If game is not paused, then unlock the sem 10 times
-        if (!app->game->paused) {
-            for (int i = 0; i < app->shellArgs->height; i++) {
-                sem_post(&runThreads);
-            }
-            // Synchronise at end of all the threads
-            for (int i = 0; i < app->shellArgs->height; i++) {
-                sem_wait(&finishedThreads);
-            }
+        for (uint32_t i = 0; i < header->planeCount; i++) {
+            s4354198_sparse_load_tile(app->game->world, tiles[i].tileX, tiles[i].tileY, 
+                tiles[i].cells);
+            count_cells(tiles[i].cells, SPARSE_TILE_SIDE * SPARSE_TILE_SIDE);
         }
+    } else if (app->game->life == NULL) {
+        CellId* cells = (CellId*) checkpoint->planes;
 
-        add_new_life_forms();
+        for (int y = 0; y < header->height; y++) {
+            CellId* row = &cells[(size_t) y * header->width];
 
-        if (!app->silence) {
-            send_to_display();
+            memcpy(s4354198_grid_row(app->game->oldState, y), row, 
+                sizeof(CellId) * header->width);
+            if (app->game->oldBits != NULL) {
+                s4354198_bitgrid_load_row(app->game->oldBits, y, row);
+            }
+            count_cells(row, header->width);
         }
+    }
+    s4354198_census_merge(app->game->census);
+
+    app->shellArgs->rule = *rule;
+    apply_rule();
+    app->game->generation = header->generation;
+    app->game->viewX = header->viewX;
+    app->game->viewY = header->viewY;
+    restore_life_forms(checkpoint);
+
+    s4354198_cycle_reset(app->game->cycle);
+    if (app->game->history != NULL) {
+        s4354198_history_reset(app->game->history);
+    }
+    record_history(false);
 
-        copy_new_state_to_old();
+    report_missing(before, count);
 
-        sem_post(&runGame);
+    // The shell must not hand out ids that are already on the board
+    lock_print_to_shell("%s %d\n", COMMS_LAST_ID, header->lastId);
 
-        usleep(app->shellArgs->refreshRate * 1000);
-    }
+    return true;
 }
 
 /**
- * Copies the new state to the old state
+ * Replaces the lifeforms waiting to be drawn with a checkpoint's
  */
-void copy_new_state_to_old(void) {
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            app->game->oldState[i][j] = app->game->newState[i][j];
-        }
+void restore_life_forms(Checkpoint* checkpoint) {
+    QueueNode* node;
+
+    while ((node = s4354198_queue_pop(app->game->newLifeForms)) != NULL) {
+        free_life_form((LifeForm*) node);
+    }
+
+    for (int i = 0; i < checkpoint->header->lifeFormCount; i++) {
+        CheckpointLifeForm* saved = &(checkpoint->lifeForms[i]);
+        LifeForm* lifeForm = (LifeForm*) malloc(sizeof(LifeForm));
+
+        lifeForm->id = saved->id;
+        lifeForm->x = saved->x;
+        lifeForm->y = saved->y;
+        lifeForm->lifeType = (LifeType) saved->lifeType;
+        lifeForm->formType = (FormType) saved->formType;
+        lifeForm->pattern = NULL;
+
+        s4354198_queue_push(app->game->newLifeForms, &(lifeForm->node));
     }
 }
 
 /**
- * Handles the individual row logic
+ * Adds the live cells of a run of cells to the census
  */
-void* row_logic(void* voidPtr) {
-    int row = *((int*) voidPtr);
-    free((int*) voidPtr);
-    bool stop = false;
-    int width = app->shellArgs->width;
+void count_cells(const CellId* cells, int length) {
+    Census* census = app->game->census;
 
-    while (!stop) {
-        sem_wait(&runThreads);
-        
-        int** newState = app->game->newState;
-        int* myState = newState[row];
-
-        for (int i = 0; i < width; i++) {
-            int id = myState[i];
-
-            int neighbours = count_neighbours(row, i);
-            int highest = highest_neighbour(row, i);
-
-            if (id > 0) {
-                if (neighbours < 2) { // Under population
-                    myState[i] = 0;
-                } else if (neighbours == 2 || neighbours == 3) { // Survive and take
-                    myState[i] = highest;
-                } else if (neighbours > 3) { // Over population
-                    myState[i] = 0;
-                }
-            } else {
-                if (neighbours == 3) {
-                    myState[i] = highest;
-                }
-            }
+    for (int i = 0; i < length; i++) {
+        if (cells[i] != 0) {
+            s4354198_census_record(census, app->game->workerCount, 0, cells[i]);
         }
-
-        sem_post(&finishedThreads);
-
-        usleep(50000);
     }
-
-    return NULL;
 }
 
 /**
- * Counts the neighbours of a cell
+ * Kills every cell and forgets every id without telling the shell, as
+ * the board is about to be filled in again
  */
-int count_neighbours(int row, int i) {
-    int count = 0;
+void empty_board(void) {
+    s4354198_census_reset(app->game->census);
+    s4354198_idmap_reset(app->game->ids);
 
-    int** state = app->game->oldState;
+    if (app->game->world != NULL) {
+        s4354198_sparse_clear(app->game->world);
+        return;
+    }
 
-    // All the coords to check
-    int pairs[8][2] = {
-        {row - 1, i - 1},
-        {row - 1, i},
-        {row - 1, i + 1},
-        {row, i - 1},
-        {row, i + 1},
-        {row + 1, i - 1},
-        {row + 1, i},
-        {row + 1, i + 1}
-    };
+    s4354198_grid_clear(app->game->oldState);
+    s4354198_grid_clear(app->game->newState);
+    s4354198_activity_mark_all(app->game->activity);
 
-    // Check each coord
-    for (int j = 0; j < 8; j++) {
-        int y = pairs[j][0];
-        int x = pairs[j][1];
+    if (app->game->newBits != NULL) {
+        s4354198_bitgrid_clear(app->game->oldBits);
+        s4354198_bitgrid_clear(app->game->newBits);
+    }
+}
 
-        if (safe_coords(y, x)) {
-            if (state[y][x] != 0) {
-                count++;
-            }
-        }
+/**
+ * Gets a copy of the lifeform ids that have cells, for report_missing
+ */
+int* living_ids(int* count) {
+    if (app->game->life != NULL) {
+        Hashlife* life = app->game->life;
+        int* ids = (int*) malloc(sizeof(int) * (life->idCount + 1));
+
+        memcpy(ids, life->ids, sizeof(int) * life->idCount);
+        *count = life->idCount;
+        return ids;
     }
 
-    //lock_print_to_shell("Count %d for %d,%d\n", count, i, row);
+    Census* census = app->game->census;
+    *count = s4354198_census_alive(census);
+    int* ids = (int*) malloc(sizeof(int) * (*count + 1));
+
+    memcpy(ids, census->dead, sizeof(int) * *count);
+    real_ids(ids, *count);
 
-    return count;
+    return ids;
 }
 
 /**
- * Get the value of the highest neighbour
+ * Reports the lifeforms from a list made by living_ids that no longer 
+ * have any cells and are not waiting to be drawn, then frees the list
  */
-int highest_neighbour(int row, int i) {
-    int max = 0;
-    
-    int** state = app->game->oldState;
-
-    // All the coords to check
-    int pairs[8][2] = {
-        {row - 1, i - 1},
-        {row - 1, i},
-        {row - 1, i + 1},
-        {row, i - 1},
-        {row, i + 1},
-        {row + 1, i - 1},
-        {row + 1, i},
-        {row + 1, i + 1}
+void report_missing(int* ids, int count) {
+    int dead = 0;
+
+    for (int i = 0; i < count; i++) {
+        bool alive = false;
+
+        for (QueueNode* node = s4354198_queue_first(app->game->newLifeForms); 
+                node != NULL && !alive; node = s4354198_queue_next(app->game->newLifeForms, node)) {
+            alive = (((LifeForm*) node)->id == ids[i]);
+        }
+
+        if (!alive && app->game->life != NULL) {
+            Hashlife* life = app->game->life;
+
+            for (int j = 0; j < life->idCount && !alive; j++) {
+                alive = (life->ids[j] == ids[i]);
+            }
+        } else if (!alive) {
+            int compact = s4354198_idmap_find(app->game->ids, ids[i]);
+            alive = (compact >= 0 && app->game->census->alive[compact]);
+        }
+
+        if (!alive) {
+            ids[dead++] = ids[i];
+        }
+    }
+
+    send_ids_to_shell(COMMS_DEAD, ids, dead);
+    free(ids);
+}
+
+/**
+ * Switches every engine over to a new rule between generations
+ */
+void handle_rule(char* input) {
+    Rule rule;
+
+    if (!s4354198_rule_parse(input, &rule)) {
+        lock_print_to_shell("Invalid rule (%s)\n", input == NULL ? "" : input);
+        return;
+    }
+
+    lock_game();
+    resume_cycle();
+    app->shellArgs->rule = rule;
+    apply_rule();
+    sem_post(&runGame);
+}
+
+/**
+ * Hands the current rule to the kernels. Quiet tiles were only quiet under 
+ * the old rule, so everything is woken up.
+ */
+void apply_rule(void) {
+    Rule* rule = &(app->shellArgs->rule);
+
+    app->game->rule = *rule;
+    s4354198_grid_set_rule(rule);
+    s4354198_bitgrid_set_rule(rule);
+
+    if (app->game->life != NULL) {
+        s4354198_hashlife_set_rule(app->game->life, rule);
+    }
+
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_set_rule(app->game->shards, rule));
+    }
+
+    if (app->game->activity != NULL) {
+        s4354198_activity_mark_all(app->game->activity);
+    }
+}
+
+/**
+ * Handles the creation of a new lifeform. Queued without a lock, so the
+ * game loop is never held up by the shell.
+ */
+void handle_new_life_form(char* input) {
+    int id = -1;
+    LifeType lifeType = CELL;
+    FormType formType = ALIVE;
+    int x = 0;
+    int y = 0;
+    char* token;
+    char* endToken;
+
+    for (int i = 0; i < 5; i++) {
+        token = strsep(&input, " ");
+
+        if (token == NULL) {
+            lock_print_to_shell("Incomplete lifeform, ignoring it\n");
+            return;
+        }
+
+        switch (i) {
+            case 0:
+                id = strtol(token, &endToken, 10);
+                break;
+            case 1:
+                lifeType = (LifeType) strtol(token, &endToken, 10);
+                break;
+            case 2:
+                formType = (FormType) strtol(token, &endToken, 10);
+                break;
+            case 3:
+                x = strtol(token, &endToken, 10);
+                break;
+            case 4:
+                y = strtol(token, &endToken, 10);
+                break;
+        }
+    }
+
+    LifeForm *new = (LifeForm*) malloc(sizeof(LifeForm));
+    new->id = id;
+    new->x = x;
+    new->y = y;
+    new->lifeType = lifeType;
+    new->formType = formType;
+    new->pattern = NULL;
+
+    s4354198_queue_push(universe->newLifeForms, &(new->node));
+}
+
+/**
+ * Handles many new lifeforms sent in one message, each separated by a comma
+ */
+void handle_new_batch(char* input) {
+    char* lifeForm;
+
+    while ((lifeForm = strsep(&input, NEWBATCH_SEPARATOR)) != NULL) {
+        if (strlen(lifeForm) > 0) {
+            handle_new_life_form(lifeForm);
+        }
+    }
+}
+
+/**
+ * Handles an imported pattern. The line gives "id x y width height" and is
+ * followed by the pattern's packed rows, exactly as the shell holds them.
+ */
+void handle_pattern(char* input) {
+    int values[5];
+    char* token;
+    char* endToken;
+
+    for (int i = 0; i < 5; i++) {
+        token = strsep(&input, " ");
+        // The rows that follow cannot be found again, so this is fatal
+        if (token == NULL) {
+            s4354198_exit(1, "Corrupt pattern from the shell\n");
+        }
+        values[i] = strtol(token, &endToken, 10);
+    }
+
+    Pattern* pattern = s4354198_pattern_create(values[3], values[4]);
+    if (pattern == NULL) {
+        s4354198_exit(1, "Pattern from the shell is too big (%dx%d)\n", values[3], values[4]);
+    }
+
+    size_t bytes = s4354198_pattern_bytes(pattern);
+    if (fread(pattern->bits, 1, bytes, app->comms->fromShell) != bytes) {
+        s4354198_pattern_free(pattern);
+        return;
+    }
+
+    LifeForm *new = (LifeForm*) malloc(sizeof(LifeForm));
+    new->id = values[0];
+    new->x = values[1];
+    new->y = values[2];
+    new->lifeType = PATTERN;
+    new->formType = IMPORTED;
+    new->pattern = pattern;
+
+    s4354198_queue_push(universe->newLifeForms, &(new->node));
+}
+
+/**
+ * Frees a lifeform along with any pattern it carries
+ */
+void free_life_form(LifeForm* lifeForm) {
+    s4354198_pattern_free(lifeForm->pattern);
+    free(lifeForm);
+}
+
+/**
+ * Builds the patterns of the built in forms
+ */
+void create_forms(void) {
+    // One word per row, bit n being the cell n to the right of x
+    static const uint64_t cell[] = {0x1};
+    static const uint64_t block[] = {0x3, 0x3};
+    static const uint64_t beehive[] = {0x6, 0x9, 0x6};
+    static const uint64_t loaf[] = {0x6, 0x9, 0xa, 0x4};
+    static const uint64_t boat[] = {0x3, 0x5, 0x2};
+    static const uint64_t blinker[] = {0x1, 0x1, 0x1};
+    static const uint64_t toad[] = {0xe, 0x7};
+    static const uint64_t beacon[] = {0x3, 0x1, 0x8, 0xc};
+    static const uint64_t glider[] = {0x5, 0x6, 0x2};
+
+    forms[ALIVE] = s4354198_pattern_from_rows(1, 1, cell);
+    forms[DEAD] = s4354198_pattern_from_rows(1, 1, cell);
+    forms[BLOCK] = s4354198_pattern_from_rows(2, 2, block);
+    forms[BEEHIVE] = s4354198_pattern_from_rows(4, 3, beehive);
+    forms[LOAF] = s4354198_pattern_from_rows(4, 4, loaf);
+    forms[BOAT] = s4354198_pattern_from_rows(3, 3, boat);
+    forms[BLINKER] = s4354198_pattern_from_rows(1, 3, blinker);
+    forms[TOAD] = s4354198_pattern_from_rows(4, 2, toad);
+    forms[BEACON] = s4354198_pattern_from_rows(4, 4, beacon);
+    forms[GLIDER] = s4354198_pattern_from_rows(3, 3, glider);
+}
+
+/**
+ * Gives the live cells of a pattern an id, with its top left corner at a 
+ * board position. Cells off the board are left out. The pattern is read a
+ * board word at a time and each run of live cells in it is drawn at once.
+ */
+void stamp_pattern(Grid* state, int id, Pattern* pattern, int y, int x) {
+    int width = app->shellArgs->width;
+    int height = app->shellArgs->height;
+    int rowStart = (y > 0) ? y : 0;
+    int rowEnd = (y + pattern->height < height) ? y + pattern->height : height;
+    int xStart = (x > 0) ? x : 0;
+    int xEnd = (x + pattern->width < width) ? x + pattern->width : width;
+
+    if (rowStart >= rowEnd || xStart >= xEnd) {
+        return;
+    }
+
+    // Hashlife takes the whole pattern at once, cut down to the board
+    if (app->game->life != NULL) {
+        Pattern* board = pattern;
+        if (rowEnd - rowStart != pattern->height || xEnd - xStart != pattern->width) {
+            board = s4354198_pattern_crop(pattern, xStart - x, rowStart - y, 
+                xEnd - xStart, rowEnd - rowStart);
+        }
+
+        s4354198_hashlife_stamp(app->game->life, board, app->game->viewX + xStart, 
+            app->game->viewY + rowStart, id != 0);
+
+        if (board != pattern) {
+            s4354198_pattern_free(board);
+        }
+        return;
+    }
+
+    for (int row = rowStart; row < rowEnd; row++) {
+        int wordX = xStart - xStart % BITGRID_WORD_BITS;
+
+        for (; wordX < xEnd; wordX += BITGRID_WORD_BITS) {
+            uint64_t bits = s4354198_pattern_bits(pattern, row - y, wordX - x);
+
+            // Only the part of the word on the board is drawn
+            if (wordX < xStart) {
+                bits &= ~0ULL << (xStart - wordX);
+            }
+            if (xEnd - wordX < BITGRID_WORD_BITS) {
+                bits &= (1ULL << (xEnd - wordX)) - 1;
+            }
+
+            while (bits != 0) {
+                int start = __builtin_ctzll(bits);
+                uint64_t rest = ~(bits >> start);
+                int length = (rest == 0) ? BITGRID_WORD_BITS - start : __builtin_ctzll(rest);
+
+                draw_run(state, id, row, wordX + start, length);
+
+                bits = (start + length == BITGRID_WORD_BITS) ? 0 : 
+                    bits & (~0ULL << (start + length));
+            }
+        }
+    }
+}
+
+/**
+ * Gives a run of cells within one board word an id. Unbounded universes 
+ * are drawn on where the view is.
+ */
+void draw_run(Grid* state, int id, int y, int x, int length) {
+    CellId previous[BITGRID_WORD_BITS];
+    int slot = app->game->workerCount;
+
+    // Shards count their own cells, which are gathered when they are synced
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_draw(app->game->shards, id, y, x, length));
+        return;
+    }
+
+    if (app->game->world != NULL) {
+        y += app->game->viewY;
+        x += app->game->viewX;
+        s4354198_sparse_set_run(app->game->world, x, y, length, id, previous);
+    } else {
+        CellId* cells = &(s4354198_grid_row(state, y)[x]);
+
+        memcpy(previous, cells, sizeof(CellId) * length);
+        for (int i = 0; i < length; i++) {
+            cells[i] = id;
+        }
+        // Runs never leave their word, so they never leave their tile
+        s4354198_activity_mark(app->game->activity, y, x);
+
+        if (app->game->oldBits != NULL) {
+            uint64_t* word = &(s4354198_bitgrid_row(app->game->oldBits, y)[1 + x / BITGRID_WORD_BITS]);
+            uint64_t mask = ((length == BITGRID_WORD_BITS) ? ~0ULL : ((1ULL << length) - 1)) <<
+                (x % BITGRID_WORD_BITS);
+
+            *word = (id != 0) ? (*word | mask) : (*word & ~mask);
+        }
+    }
+
+    // The id gains every cell of the run it did not already have
+    int gained = 0;
+    for (int i = 0; i < length; i++) {
+        if (previous[i] != id) {
+            s4354198_census_add(app->game->census, slot, previous[i], -1);
+            gained++;
+        }
+    }
+    if (gained > 0) {
+        s4354198_census_add(app->game->census, slot, id, gained);
+    }
+
+    if (app->game->history != NULL) {
+        s4354198_history_push(app->game->history, x, y, length, 
+            s4354198_idmap_real(app->game->ids, id));
+    }
+}
+
+/**
+ * Gives a cell a new compact id, keeping the census and the bit engine in
+ * step. Sparse coordinates are in the universe, all others on the board.
+ */
+void set_cell(Grid* state, int y, int x, CellId id) {
+    if (app->game->world != NULL) {
+        CellId previous = s4354198_sparse_set(app->game->world, x, y, id);
+        s4354198_census_record(app->game->census, app->game->workerCount, previous, id);
+        return;
+    }
+
+    CellId* cell = &(s4354198_grid_row(state, y)[x]);
+    s4354198_census_record(app->game->census, app->game->workerCount, *cell, id);
+    *cell = id;
+    s4354198_activity_mark(app->game->activity, y, x);
+
+    if (app->game->oldBits != NULL) {
+        s4354198_bitgrid_set(app->game->oldBits, y, x, id != 0);
+    }
+}
+
+/**
+ * Adds new lifeforms to the game state. Returns true if there were any.
+ */
+bool add_new_life_forms(void) {
+    QueueNode* node;
+    Grid* state = app->game->oldState;
+    bool drawn = !s4354198_queue_empty(app->game->newLifeForms);
+
+    if (drawn) {
+        resume_cycle();
+        state = app->game->oldState;
+        // Drawn cells are added to this generation's entry
+        record_history(false);
+    }
+
+    // Iterate through all life forms and add them
+    while ((node = s4354198_queue_pop(app->game->newLifeForms)) != NULL) {
+        LifeForm* lifeForm = (LifeForm*) node;
+
+        // Hashlife has no per cell ids, so it only needs to know who was drawn
+        int id = lifeForm->id;
+        if (app->game->life != NULL && id != 0) {
+            s4354198_hashlife_add_id(app->game->life, id);
+        } else if (app->game->life == NULL) {
+            id = compact_id(lifeForm->id);
+        }
+        int x = lifeForm->x;
+        int y = lifeForm->y;
+
+        // Change to 0 indexing
+        x--;
+        y--;
+
+        if (id < 0) {
+            lock_print_to_shell("No room for lifeform %d\n", lifeForm->id);
+            free_life_form(lifeForm);
+            continue;
+        }
+
+        Pattern* pattern = lifeForm->pattern;
+        if (pattern == NULL && lifeForm->formType >= ALIVE && lifeForm->formType < IMPORTED) {
+            pattern = forms[lifeForm->formType];
+        }
+
+        if (pattern != NULL) {
+            stamp_pattern(state, id, pattern, y, x);
+        }
+
+        free_life_form(lifeForm);
+    }
+
+    // Hashlife's entry is its root, which drawing has replaced
+    if (drawn && app->game->life != NULL) {
+        record_history(false);
+    }
+
+    report_dead();
+
+    return drawn;
+}
+
+/**
+ * Notifies the shell of every id that lost its last cell this tick,
+ * batched into a single message
+ */
+void report_dead(void) {
+    Hashlife* life = app->game->life;
+
+    // Hashlife can only tell that everything has died
+    if (life != NULL) {
+        if (life->root->population == 0) {
+            send_ids_to_shell(COMMS_DEAD, life->ids, life->idCount);
+            life->idCount = 0;
+        }
+        return;
+    }
+
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_sync(app->game->shards, app->game->census, 
+            app->game->workerCount));
+    }
+
+    int count = s4354198_census_merge(app->game->census);
+
+    real_ids(app->game->census->dead, count);
+    send_ids_to_shell(COMMS_DEAD, app->game->census->dead, count);
+}
+
+/**
+ * Sends a command followed by some lifeform ids
+ */
+void send_ids_to_shell(const char* command, int* ids, int count) {
+    if (count == 0) {
+        return;
+    }
+
+    // Enough room for every id and its separating space
+    char message[count * 12 + 1];
+    int index = 0;
+    for (int i = 0; i < count; i++) {
+        index += sprintf(&message[index], " %d", ids[i]);
+    }
+
+    lock_print_to_shell("%s%s\n", command, message);
+}
+
+/**
+ * Turns a list of compact ids into lifeform ids in place
+ */
+void real_ids(int* ids, int count) {
+    for (int i = 0; i < count; i++) {
+        ids[i] = s4354198_idmap_real(app->game->ids, ids[i]);
+    }
+}
+
+/**
+ * Gets the compact id stored in the grid for a lifeform id. Returns -1
+ * if there is no room for another id.
+ */
+int compact_id(int realId) {
+    IdMap* ids = app->game->ids;
+
+    if (realId == 0) {
+        return 0;
+    }
+
+    int compact = s4354198_idmap_find(ids, realId);
+    if (compact >= 0) {
+        return compact;
+    }
+
+    if (!s4354198_idmap_can_append(ids, realId)) {
+        return renumber_ids(realId);
+    }
+
+    compact = s4354198_idmap_append(ids, realId);
+    s4354198_census_reserve(app->game->census, compact);
+
+    return compact;
+}
+
+/**
+ * Hands out compact ids again to just the living lifeforms and realId,
+ * keeping them in order, and rewrites the grids to match. Returns the
+ * compact id of realId, or -1 if they still do not fit.
+ */
+int renumber_ids(int realId) {
+    Census* census = app->game->census;
+    IdMap* ids = app->game->ids;
+    int oldCount = ids->count;
+    CellId* remap = (CellId*) malloc(sizeof(CellId) * oldCount);
+
+    // Settle the counts so only ids that still have cells are kept
+    report_dead();
+
+    if (!s4354198_idmap_rebuild(ids, census->alive, realId, remap)) {
+        free(remap);
+        return -1;
+    }
+
+    s4354198_census_remap(census, remap, oldCount);
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_remap(app->game->shards, remap, oldCount));
+    } else if (app->game->world != NULL) {
+        s4354198_sparse_remap(app->game->world, remap);
+    } else {
+        s4354198_grid_remap(app->game->oldState, remap);
+        s4354198_grid_remap(app->game->newState, remap);
+    }
+    free(remap);
+
+    int compact = s4354198_idmap_find(ids, realId);
+    s4354198_census_reserve(census, compact);
+
+    return compact;
+}
+
+/**
+ * Handles output from the display
+ */
+void* display_out_handler(void* voidPtr) {
+    bool stop = false;
+    char* input = NULL;
+    char* cleanedInput = NULL;
+    size_t size;
+
+    while (!stop) {
+        int read = getline(&input, &size, app->comms->fromDisplay);
+        
+        if (read == -1) {
+            stop = true;
+        } else {
+            // Remove the newline from the end
+            cleanedInput = (char*) malloc(sizeof(char) * strlen(input));
+            strncpy(cleanedInput, input, strlen(input) - 1);
+            cleanedInput[strlen(input) - 1] = '\0';
+
+            lock_print_to_shell("(Display) %s\n", cleanedInput);
+
+            free(cleanedInput);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Builds and writes each snapshot the game loop hands over, so a slow
+ * frame holds up the next frame rather than the next generation
+ */
+void* frame_out_handler(void* voidPtr) {
+    while (true) {
+        sem_wait(&snapshotReady);
+
+        Snapshot* snapshot = framing->snapshot;
+        FrameWriter* frame = framing->frame;
+
+        if (snapshot->hasLine) {
+            lock_print_to_display("%s\n", snapshot->line);
+        } else {
+            s4354198_snapshot_write(snapshot, frame);
+            lock_print_to_display("%s\n", s4354198_frame_writer_finish(frame));
+        }
+
+        sem_post(&snapshotFree);
+    }
+
+    return NULL;
+}
+
+/**
+ * Sends the current game state to the display. Only the copy is made 
+ * here, the frame thread builds and writes it while the game goes on.
+ */
+void send_to_display(void) {
+    Snapshot* snapshot = app->game->snapshot;
+    Cycle* cycle = app->game->cycle;
+
+    // Only the default universe, which has no tag, is drawn. The others 
+    // cache an empty frame for each tick so a settled cycle still idles.
+    if (app->game->tag[0] != '\0') {
+        s4354198_cycle_cache_frame(cycle, "", cycle->ticks);
+        return;
+    }
+
+    // The frame before has to be written before the snapshot is reused
+    sem_wait(&snapshotFree);
+
+    // Which also makes it ready for a cycle that is being confirmed
+    if (!snapshot->hasLine) {
+        s4354198_cycle_cache_frame(cycle, app->game->frame->buffer, snapshot->tick);
+    }
+
+    snapshot->tick = cycle->ticks;
+    if (s4354198_cycle_can_idle(cycle)) {
+        s4354198_snapshot_set_line(snapshot, s4354198_cycle_frame(cycle));
+    } else {
+        capture_snapshot(snapshot);
+    }
+
+    framing = app->game;
+    sem_post(&snapshotReady);
+}
+
+/**
+ * Copies the visible part of the board into a snapshot
+ */
+void capture_snapshot(Snapshot* snapshot) {
+    int width = app->shellArgs->width;
+    int height = app->shellArgs->height;
+
+    if (app->game->life != NULL) {
+        // Every live cell shows as the highest id drawn
+        int toReal[2] = {0, s4354198_hashlife_highest_id(app->game->life)};
+
+        s4354198_hashlife_capture(app->game->life, app->game->viewX, app->game->viewY, 
+            width, height, 1, snapshot->cells);
+        s4354198_snapshot_set_ids(snapshot, toReal, 2);
+        return;
+    }
+
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_capture(app->game->shards, snapshot->cells));
+    } else if (app->game->world != NULL) {
+        s4354198_sparse_capture(app->game->world, app->game->viewX, app->game->viewY,
+            width, height, snapshot->cells);
+    } else {
+        for (int i = 0; i < height; i++) {
+            memcpy(s4354198_snapshot_row(snapshot, i), 
+                s4354198_grid_row(app->game->oldState, i), sizeof(CellId) * width);
+        }
+    }
+
+    s4354198_snapshot_set_ids(snapshot, app->game->ids->toReal, app->game->ids->count);
+}
+
+/**
+ * Clears all states
+ */
+void clear_states(void) {
+    Census* census = app->game->census;
+
+    if (app->game->life != NULL) {
+        Hashlife* life = app->game->life;
+
+        send_ids_to_shell(COMMS_DEAD, life->ids, life->idCount);
+        s4354198_hashlife_clear(life);
+        s4354198_cycle_reset(app->game->cycle);
+        return;
+    }
+
+    if (app->game->history != NULL) {
+        s4354198_history_reset(app->game->history);
+    }
+
+    // Everything still alive is about to die
+    int count = s4354198_census_alive(census);
+    real_ids(census->dead, count);
+    send_ids_to_shell(COMMS_DEAD, census->dead, count);
+    s4354198_census_reset(census);
+    s4354198_idmap_reset(app->game->ids);
+
+    // Zero everything
+    s4354198_cycle_reset(app->game->cycle);
+    if (app->game->shards != NULL) {
+        check_shards(s4354198_shards_clear(app->game->shards));
+        return;
+    }
+    if (app->game->world != NULL) {
+        s4354198_sparse_clear(app->game->world);
+        return;
+    }
+    s4354198_grid_clear(app->game->oldState);
+    s4354198_grid_clear(app->game->newState);
+    s4354198_activity_mark_all(app->game->activity);
+
+    if (app->game->newBits != NULL) {
+        s4354198_bitgrid_clear(app->game->oldBits);
+        s4354198_bitgrid_clear(app->game->newBits);
+    }
+}
+
+/**
+ * Stops if a shard has gone, as part of the board went with it
+ */
+void check_shards(bool ok) {
+    if (!ok) {
+        s4354198_exit(1, "Lost contact with a shard of the board\n");
+    }
+}
+
+/**
+ * Runs the game logic. Every universe takes a turn each tick, on the 
+ * shared worker pool, with the game lock let go between turns so 
+ * commands get in. The default universe's ticker paces them all.
+ */
+void run_game_logic(void) {
+    bool stop = false;
+
+    while (!stop) {
+        int count = __atomic_load_n(&universeCount, __ATOMIC_ACQUIRE);
+        bool working = false;
+
+        for (int i = 0; i < count; i++) {
+            sem_wait(&runGame);
+            switch_universe(universes[i]);
+            tick_universe();
+            working = working || !app->game->paused;
+            sem_post(&runGame);
+
+            give_way();
+        }
+
+        s4354198_ticker_wait(universes[0]->ticker, working);
+    }
+}
+
+/**
+ * Takes the current universe on a tick, unless it is paused, and draws 
+ * anything waiting for it
+ */
+void tick_universe(void) {
+    unsigned long generation = app->game->generation;
+    bool idle = !app->game->paused && s4354198_cycle_can_idle(app->game->cycle);
+
+    if (idle) {
+        // A settled board just replays its cycle from the cache
+        s4354198_cycle_idle_tick(app->game->cycle);
+        app->game->generation += (app->game->life != NULL) ? 
+            1UL << app->shellArgs->stepLog : 1;
+    } else if (!app->game->paused) {
+        step_generation();
+    }
+    bool stepped = !idle && app->game->generation != generation;
+
+    // Drawing starts the search for a cycle over
+    if (!add_new_life_forms() && stepped) {
+        observe_cycle();
+    }
+
+    // Unthrottled, frames are only sent as often as the display can use them
+    if (!app->silence && s4354198_ticker_frame_due(app->game->ticker)) {
+        send_to_display();
+    }
+}
+
+/**
+ * Takes the game lock from outside the game loop, to work on this 
+ * thread's universe
+ */
+void lock_game(void) {
+    __atomic_add_fetch(&gameWaiters, 1, __ATOMIC_ACQ_REL);
+    sem_wait(&runGame);
+    __atomic_sub_fetch(&gameWaiters, 1, __ATOMIC_ACQ_REL);
+    switch_universe(universe);
+}
+
+/**
+ * Lets anyone waiting for the game lock have it before the next tick. 
+ * Without this a loop with no time left to sleep takes the lock straight 
+ * back and commands from the shell never get in.
+ */
+void give_way(void) {
+    while (__atomic_load_n(&gameWaiters, __ATOMIC_ACQUIRE) > 0) {
+        sched_yield();
+    }
+}
+
+/**
+ * Computes the next generation with whichever engine is running
+ */
+void step_generation(void) {
+    // Handing small generations to the pool costs more than computing them
+    // here, using the game loop's census slot
+    Worker self = {.index = app->game->workerCount};
+
+    if (app->game->life != NULL) {
+        step_universe();
+    } else if (app->game->shards != NULL) {
+        // Synced straight away, so the counts and signature are up to date
+        // like the other engines'
+        ShardSet* shards = app->game->shards;
+
+        check_shards(s4354198_shards_step(shards, 1) && 
+            s4354198_shards_sync(shards, app->game->census, app->game->workerCount));
+        app->game->generation++;
+    } else if (app->game->world != NULL) {
+        SparseWorld* world = app->game->world;
+
+        s4354198_sparse_expand(world);
+
+        if (world->tileCount * SPARSE_TILE_SIDE * SPARSE_TILE_SIDE <= INLINE_CELL_LIMIT ||
+                !deal_tiles()) {
+            sparse_logic(&self, 0, world->tileCount);
+        } else {
+            s4354198_barrier_wait(&startGeneration);
+            s4354198_barrier_wait(&finishGeneration);
+        }
+
+        // Recorded before the flip frees the tiles that just emptied
+        app->game->generation++;
+        record_history(true);
+        s4354198_sparse_flip(world);
+    } else {
+        Activity* activity = app->game->activity;
+
+        if (app->shellArgs->torus) {
+            wrap_edges();
+        }
+        int active = s4354198_activity_plan(activity);
+
+        if (active * ACTIVITY_TILE_ROWS * ACTIVITY_TILE_COLS <= INLINE_CELL_LIMIT ||
+                !deal_tiles()) {
+            step_tiles(&self, 0, activity->tileRows);
+        } else {
+            // Release the workers for one generation and wait for all the tiles
+            s4354198_barrier_wait(&startGeneration);
+            s4354198_barrier_wait(&finishGeneration);
+        }
+
+        swap_states();
+        app->game->generation++;
+        record_history(true);
+    }
+}
+
+/**
+ * Adds the signature of the generation just computed to the cycle 
+ * history, and tells the shell once the board has settled
+ */
+void observe_cycle(void) {
+    Cycle* cycle = app->game->cycle;
+    uint64_t signature;
+    bool empty;
+
+    if (app->game->life != NULL) {
+        signature = s4354198_hashlife_signature(app->game->life);
+        empty = app->game->life->root->population == 0;
+    } else if (app->game->shards != NULL) {
+        signature = app->game->shards->signature;
+        empty = app->game->census->population == 0;
+    } else if (app->game->world != NULL) {
+        signature = s4354198_sparse_signature(app->game->world);
+        empty = app->game->census->population == 0;
+    } else {
+        signature = s4354198_activity_signature(app->game->activity);
+        empty = app->game->census->population == 0;
+    }
+
+    s4354198_cycle_observe(cycle, signature, app->game->generation);
+
+    if (!s4354198_cycle_settled(cycle) || cycle->reported) {
+        return;
+    }
+    cycle->reported = true;
+
+    if (empty) {
+        lock_print_to_shell("Board died out at generation %lu\n", cycle->startGeneration);
+    } else if (cycle->period == 1) {
+        lock_print_to_shell("Board became a still life at generation %lu\n", 
+            cycle->startGeneration);
+    } else {
+        lock_print_to_shell("Board repeats every %lu generations from generation %lu\n",
+            cycle->period, cycle->startGeneration);
+    }
+}
+
+/**
+ * Brings the engine back in step with a replayed cycle and starts looking
+ * for a new one, as the board is about to change
+ */
+void resume_cycle(void) {
+    Cycle* cycle = app->game->cycle;
+    int behind = s4354198_cycle_behind(cycle);
+
+    // These generations were already counted while replaying, so count
+    // them again as they are computed
+    app->game->generation -= behind * 
+        ((app->game->life != NULL) ? 1UL << app->shellArgs->stepLog : 1);
+    for (int i = 0; i < behind; i++) {
+        step_generation();
+    }
+
+    s4354198_cycle_reset(cycle);
+}
+
+/**
+ * Adds the current generation to the history if it is not there yet.
+ * Straight after a step only the changed cells are stored, otherwise the
+ * entry starts out empty for drawing to fill in.
+ */
+void record_history(bool stepped) {
+    History* history = app->game->history;
+
+    if (history == NULL) {
+        return;
+    }
+
+    if (app->game->life != NULL) {
+        s4354198_hashlife_remember(app->game->life, app->game->generation);
+        return;
+    }
+
+    HistoryEntry* last = s4354198_history_last(history);
+    if (last != NULL && last->generation == app->game->generation) {
+        return;
+    }
+
+    if (s4354198_history_begin(history, app->game->generation)->keyframe) {
+        record_board(stepped);
+    } else if (stepped) {
+        record_changes();
+    }
+}
+
+/**
+ * Records the current generation as a keyframe, for when the generations
+ * since the last entry were computed without being recorded
+ */
+void record_keyframe(void) {
+    History* history = app->game->history;
+
+    if (history == NULL) {
+        return;
+    }
+
+    HistoryEntry* last = s4354198_history_last(history);
+    if (last != NULL && last->generation == app->game->generation) {
+        return;
+    }
+
+    s4354198_history_begin_keyframe(history, app->game->generation);
+    record_board(false);
+}
+
+/**
+ * Adds every live cell of the current generation to the history. The
+ * sparse universe is recorded before its flip, so a step's generation is
+ * still in the other grid.
+ */
+void record_board(bool stepped) {
+    SparseWorld* world = app->game->world;
+
+    if (world != NULL) {
+        int which = stepped ? 1 - world->current : world->current;
+
+        for (int i = 0; i < world->tileCount; i++) {
+            SparseTile* tile = world->tiles[i];
+
+            for (int row = 0; tile->alive[which] && row < SPARSE_TILE_SIDE; row++) {
+                record_span(NULL, s4354198_grid_row(tile->grids[which], row), 
+                    tile->tileX * SPARSE_TILE_SIDE, tile->tileY * SPARSE_TILE_SIDE + row,
+                    SPARSE_TILE_SIDE);
+            }
+        }
+        return;
+    }
+
+    for (int row = 0; row < app->shellArgs->height; row++) {
+        record_span(NULL, s4354198_grid_row(app->game->oldState, row), 0, row,
+            app->shellArgs->width);
+    }
+}
+
+/**
+ * Adds the cells that changed in the step just taken to the history.
+ * Only tiles that changed are compared.
+ */
+void record_changes(void) {
+    SparseWorld* world = app->game->world;
+    Activity* activity = app->game->activity;
+
+    if (world != NULL) {
+        int current = world->current;
+
+        for (int i = 0; i < world->tileCount; i++) {
+            SparseTile* tile = world->tiles[i];
+
+            for (int row = 0; (tile->alive[0] || tile->alive[1]) && 
+                    row < SPARSE_TILE_SIDE; row++) {
+                record_span(s4354198_grid_row(tile->grids[current], row), 
+                    s4354198_grid_row(tile->grids[1 - current], row),
+                    tile->tileX * SPARSE_TILE_SIDE, tile->tileY * SPARSE_TILE_SIDE + row,
+                    SPARSE_TILE_SIDE);
+            }
+        }
+        return;
+    }
+
+    // The previous generation is left in the new state buffer
+    for (int tile = 0; tile < activity->tileRows * activity->tileCols; tile++) {
+        if (!activity->changed[tile]) {
+            continue;
+        }
+
+        int rowStart = (tile / activity->tileCols) * ACTIVITY_TILE_ROWS;
+        int rowEnd = rowStart + ACTIVITY_TILE_ROWS;
+        int xStart = (tile % activity->tileCols) * ACTIVITY_TILE_COLS;
+        int xEnd = xStart + ACTIVITY_TILE_COLS;
+
+        if (rowEnd > app->shellArgs->height) {
+            rowEnd = app->shellArgs->height;
+        }
+        if (xEnd > app->shellArgs->width) {
+            xEnd = app->shellArgs->width;
+        }
+
+        for (int row = rowStart; row < rowEnd; row++) {
+            record_span(s4354198_grid_row(app->game->newState, row) + xStart, 
+                s4354198_grid_row(app->game->oldState, row) + xStart, xStart, row, 
+                xEnd - xStart);
+        }
+    }
+}
+
+/**
+ * Adds the cells of a span that differ from the same span a generation
+ * before to the history, as runs of the same id. With no span before it
+ * every live cell is added.
+ */
+void record_span(const CellId* previous, const CellId* current, int x, int y, int length) {
+    if (previous != NULL && memcmp(previous, current, sizeof(CellId) * length) == 0) {
+        return;
+    }
+
+    int i = 0;
+    while (i < length) {
+        int start = i;
+
+        while (i < length && current[i] == current[start] && 
+                current[i] != ((previous != NULL) ? previous[i] : 0)) {
+            i++;
+        }
+
+        if (i == start) {
+            i++;
+        } else {
+            s4354198_history_push(app->game->history, x + start, y, i - start, 
+                s4354198_idmap_real(app->game->ids, current[start]));
+        }
+    }
+}
+
+
+/**
+ * Advances the hashlife universe by a whole step
+ */
+void step_universe(void) {
+    if (!s4354198_hashlife_step(app->game->life, app->shellArgs->stepLog)) {
+        app->game->paused = true;
+        lock_print_to_shell("The universe has grown too big to step, stopping\n");
+        return;
+    }
+
+    app->game->generation += 1UL << app->shellArgs->stepLog;
+    record_history(true);
+}
+
+/**
+ * Makes the newly computed generation the current one. The buffer
+ * that held the current generation is kept as the previous one.
+ */
+void swap_states(void) {
+    Grid* state = app->game->oldState;
+    app->game->oldState = app->game->newState;
+    app->game->newState = state;
+
+    if (app->game->oldBits != NULL) {
+        BitGrid* bits = app->game->oldBits;
+        app->game->oldBits = app->game->newBits;
+        app->game->newBits = bits;
+    }
+}
+
+/**
+ * Copies each edge of the current generation into the ghosts beyond the
+ * opposite edge, so the board steps as a torus
+ */
+void wrap_edges(void) {
+    s4354198_grid_wrap(app->game->oldState);
+
+    if (app->game->oldBits != NULL) {
+        s4354198_bitgrid_wrap(app->game->oldBits);
+    }
+}
+
+/**
+ * Handles the logic for a worker, which computes the tiles dealt to it 
+ * and then helps the others with theirs. Wavefronts are computed in the
+ * worker's own band of rows instead.
+ */
+void* band_logic(void* voidPtr) {
+    Worker* worker = (Worker*) voidPtr;
+    bool stop = false;
+
+    while (!stop) {
+        s4354198_barrier_wait(&startGeneration);
+
+        if (app->game->waveGenerations > 0) {
+            wavefront_band(worker);
+        } else {
+            take_tiles(worker);
+        }
+
+        s4354198_barrier_wait(&finishGeneration);
+    }
+
+    return NULL;
+}
+
+/**
+ * Shares out the tiles due this generation between the workers' deques.
+ * Each worker is dealt a run of neighbouring tiles with about the same
+ * estimated cost, going by how much changed in them last time, so the
+ * dense parts of the board are spread over more workers. Returns false if
+ * the deques could not be made big enough.
+ */
+bool deal_tiles(void) {
+    int workers = app->game->workerCount;
+    int tiles;
+    long total;
+
+    if (app->game->world != NULL) {
+        tiles = app->game->world->tileCount;
+        total = tiles;
+    } else {
+        tiles = app->game->activity->tileRows * app->game->activity->tileCols;
+        total = app->game->activity->activeCost;
+    }
+
+    for (int i = 0; i < workers; i++) {
+        Deque* deque = app->game->workers[i].tiles;
+
+        s4354198_deque_clear(deque);
+        if (!s4354198_deque_reserve(deque, tiles)) {
+            return false;
+        }
+    }
+
+    int worker = 0;
+    long dealt = 0;
+
+    for (int tile = 0; tile < tiles; tile++) {
+        int cost = tile_cost(tile);
+
+        if (cost == 0) {
+            continue;
+        }
+
+        // Move on once this worker has its share
+        while (worker < workers - 1 && dealt >= (total * (worker + 1)) / workers) {
+            worker++;
+        }
+
+        s4354198_deque_push(app->game->workers[worker].tiles, tile);
+        dealt += cost;
+    }
+
+    return true;
+}
+
+/**
+ * Gets the estimated cost of a tile this generation, 0 if it is quiet.
+ * Sparse tiles are all counted the same.
+ */
+int tile_cost(int tile) {
+    Activity* activity = app->game->activity;
+
+    if (activity == NULL) {
+        return 1;
+    }
+
+    return activity->active[tile] ? activity->costs[tile] : 0;
+}
+
+/**
+ * Computes tiles until every deque is empty
+ */
+void take_tiles(Worker* worker) {
+    int tile;
+
+    while ((tile = next_tile(worker)) != DEQUE_EMPTY) {
+        step_tile(worker, tile);
+    }
+}
+
+/**
+ * Gets the next tile for a worker, from the bottom of its own deque or
+ * else stolen from the top of another's, which is the end of the run 
+ * furthest from where their owner is working. Returns DEQUE_EMPTY once 
+ * there is nothing left anywhere.
+ */
+int next_tile(Worker* worker) {
+    int tile = s4354198_deque_pop(worker->tiles);
+
+    if (tile != DEQUE_EMPTY) {
+        return tile;
+    }
+
+    int workers = app->game->workerCount;
+
+    // Nothing is dealt mid generation, so an empty deque stays empty
+    for (int i = 1; i < workers; i++) {
+        Deque* victim = app->game->workers[(worker->index + i) % workers].tiles;
+
+        do {
+            tile = s4354198_deque_steal(victim);
+        } while (tile == DEQUE_ABORT);
+
+        if (tile != DEQUE_EMPTY) {
+            worker->steals++;
+            return tile;
+        }
+    }
+
+    return DEQUE_EMPTY;
+}
+
+/**
+ * Computes a tile taken from a deque
+ */
+void step_tile(Worker* worker, int tile) {
+    if (app->game->world != NULL) {
+        sparse_logic(worker, tile, tile + 1);
+        return;
+    }
+
+    if (app->game->blockGenerations > 0) {
+        block_tile(worker, tile);
+        return;
+    }
+
+    Activity* activity = app->game->activity;
+    Buffers buffers = {app->game->oldState, app->game->newState, 
+        app->game->oldBits, app->game->newBits};
+
+    activity->changed[tile] = tile_logic(worker, &buffers, tile / activity->tileCols, 
+        tile % activity->tileCols);
+}
+
+/**
+ * Gets the number of tiles the workers have stolen from each other
+ */
+unsigned long stolen_tiles(void) {
+    unsigned long steals = 0;
+
+    for (int i = 0; i < app->game->workerCount; i++) {
+        steals += app->game->workers[i].steals;
+    }
+
+    return steals;
+}
+
+/**
+ * Computes the active tiles in a range of tile rows
+ */
+void step_tiles(Worker* worker, int tileRowStart, int tileRowEnd) {
+    Activity* activity = app->game->activity;
+    Buffers buffers = {app->game->oldState, app->game->newState, 
+        app->game->oldBits, app->game->newBits};
+
+    // Quiet tiles already hold their next state in both buffers
+    for (int i = tileRowStart; i < tileRowEnd; i++) {
+        for (int j = 0; j < activity->tileCols; j++) {
+            int tile = i * activity->tileCols + j;
+
+            if (activity->active[tile]) {
+                activity->changed[tile] = tile_logic(worker, &buffers, i, j);
+            }
+        }
+    }
+}
+
+/**
+ * Checks if a fast forward is worth running as a wavefront. The torus 
+ * needs its edges wrapped between every generation, and small boards are
+ * quicker stepped on the game loop.
+ */
+bool wavefront_ready(unsigned long steps) {
+    return steps > 1 && app->game->activity != NULL && app->game->workerCount > 1 && 
+        !app->shellArgs->torus && 
+        (long) app->shellArgs->width * app->shellArgs->height > INLINE_CELL_LIMIT;
+}
+
+/**
+ * Computes generations of a grid engine as a wavefront across the worker
+ * pool, with no barrier between generations. It goes in chunks so that
+ * the history never has a bigger gap than between two keyframes.
+ */
+void wavefront_steps(unsigned long steps) {
+    Activity* activity = app->game->activity;
+
+    while (steps > 0) {
+        int generations = (steps < WAVEFRONT_GENERATIONS) ? (int) steps : 
+            WAVEFRONT_GENERATIONS;
+
+        for (int i = 0; i < app->game->workerCount; i++) {
+            app->game->workers[i].done = 0;
+        }
+        app->game->waveGenerations = generations;
+
+        s4354198_barrier_wait(&startGeneration);
+        s4354198_barrier_wait(&finishGeneration);
+        app->game->waveGenerations = 0;
+
+        // An odd number of generations leaves the newest in the new buffers
+        if (generations % 2 == 1) {
+            bool* changed = activity->changed;
+
+            swap_states();
+            activity->changed = activity->spare;
+            activity->spare = changed;
+        }
+
+        app->game->generation += generations;
+        steps -= generations;
+        record_keyframe();
+        report_dead();
+    }
+}
+
+/**
+ * Checks if a fast forward can use temporal blocking, which has to be 
+ * asked for as it only pays off on boards bigger than the cache
+ */
+bool temporal_ready(unsigned long steps) {
+    return steps > 1 && app->shellArgs->temporalDepth > 1 && 
+        app->game->activity != NULL && !app->shellArgs->torus;
+}
+
+/**
+ * Computes generations of a grid engine a block of several at a time. 
+ * Each tile is loaded with enough of its surroundings to be taken the 
+ * whole block on while it stays in cache, so the board is only streamed
+ * through memory once a block rather than once a generation.
+ */
+void temporal_steps(unsigned long steps) {
+    Activity* activity = app->game->activity;
+    int tiles = activity->tileRows * activity->tileCols;
+    unsigned long keyframe = app->game->generation / HISTORY_KEYFRAME_GAP;
+    Worker self = {.index = app->game->workerCount, 
+        .scratch = {app->game->scratch[0], app->game->scratch[1]}};
+
+    while (steps > 0) {
+        int generations = (steps < app->shellArgs->temporalDepth) ? (int) steps : 
+            app->shellArgs->temporalDepth;
+
+        // Tiles nothing changed near last generation stay as they are for 
+        // the whole block, as changes spread no further than the next tile
+        int active = s4354198_activity_plan(activity);
+        app->game->blockGenerations = generations;
+
+        if (active * ACTIVITY_TILE_ROWS * ACTIVITY_TILE_COLS <= INLINE_CELL_LIMIT ||
+                !deal_tiles()) {
+            for (int tile = 0; tile < tiles; tile++) {
+                if (activity->active[tile]) {
+                    block_tile(&self, tile);
+                }
+            }
+        } else {
+            s4354198_barrier_wait(&startGeneration);
+            s4354198_barrier_wait(&finishGeneration);
+        }
+
+        app->game->blockGenerations = 0;
+        swap_states();
+        app->game->generation += generations;
+        steps -= generations;
+
+        // Keyframes as often as the history would take them anyway
+        if (steps == 0 || app->game->generation / HISTORY_KEYFRAME_GAP != keyframe) {
+            keyframe = app->game->generation / HISTORY_KEYFRAME_GAP;
+            record_keyframe();
+        }
+        report_dead();
+    }
+}
+
+/**
+ * Takes a tile a block of generations on in one go. The new state buffer
+ * only gets the last of them, so a tile that changed at any point in the
+ * block is counted as changed and computed again next generation, which
+ * brings both buffers back into step before it can be skipped.
+ */
+void block_tile(Worker* worker, int tile) {
+    Activity* activity = app->game->activity;
+    int tileRow = tile / activity->tileCols;
+    int tileCol = tile % activity->tileCols;
+    int rowStart = tileRow * ACTIVITY_TILE_ROWS;
+    int rowEnd = rowStart + ACTIVITY_TILE_ROWS;
+    int xStart = tileCol * ACTIVITY_TILE_COLS;
+    int xEnd = xStart + ACTIVITY_TILE_COLS;
+    int changes = 0;
+
+    if (rowEnd > app->shellArgs->height) {
+        rowEnd = app->shellArgs->height;
+    }
+    if (xEnd > app->shellArgs->width) {
+        xEnd = app->shellArgs->width;
+    }
+
+    bool changed = s4354198_grid_step_block(app->game->oldState, app->game->newState, 
+        worker->scratch, rowStart, rowEnd, xStart, xEnd, app->game->blockGenerations);
+
+    for (int row = rowStart; row < rowEnd; row++) {
+        changes += census_span(app->game->oldState, app->game->newState, row, xStart, xEnd,
+            worker->index);
+
+        // The bit engine's liveness follows the ids, as both step the same rule
+        if (app->game->newBits != NULL) {
+            s4354198_bitgrid_load_words(app->game->newBits, row, 
+                s4354198_grid_row(app->game->newState, row), tileCol, tileCol + 1);
+        }
+    }
+
+    activity->signatures[tile] = tile_signature(app->game->newState, rowStart, rowEnd, 
+        xStart, xEnd);
+    s4354198_activity_cost(activity, tile, changes);
+    activity->changed[tile] = changed || changes > 0;
+}
+
+/**
+ * Computes a worker's band for each generation of a wavefront. A band 
+ * starts its next generation as soon as the bands either side have 
+ * finished this one, so a slow band only holds up its neighbours and 
+ * the rest of the board can be generations further on.
+ */
+void wavefront_band(Worker* worker) {
+    Activity* activity = app->game->activity;
+    int tileRowStart = worker->rowStart / ACTIVITY_TILE_ROWS;
+    int tileRowEnd = (worker->rowEnd + ACTIVITY_TILE_ROWS - 1) / ACTIVITY_TILE_ROWS;
+
+    for (int k = 1; k <= app->game->waveGenerations; k++) {
+        bool odd = (k % 2) == 1;
+        Buffers buffers = odd ? 
+            (Buffers) {app->game->oldState, app->game->newState, 
+                app->game->oldBits, app->game->newBits} :
+            (Buffers) {app->game->newState, app->game->oldState, 
+                app->game->newBits, app->game->oldBits};
+        // The changed flags alternate like the buffers
+        bool* before = odd ? activity->changed : activity->spare;
+        bool* after = odd ? activity->spare : activity->changed;
+
+        // Also means they have finished reading what this generation overwrites
+        wait_for_band(worker->index - 1, k - 1);
+        wait_for_band(worker->index + 1, k - 1);
+
+        for (int i = tileRowStart; i < tileRowEnd; i++) {
+            for (int j = 0; j < activity->tileCols; j++) {
+                after[i * activity->tileCols + j] = 
+                    s4354198_activity_due(activity, before, i, j) && 
+                    tile_logic(worker, &buffers, i, j);
+            }
+        }
+
+        __atomic_store_n(&(worker->done), k, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * Waits for a worker to finish a generation of a wavefront. There are no
+ * workers past the edges of the board to wait for.
+ */
+void wait_for_band(int index, int generation) {
+    if (index < 0 || index >= app->game->workerCount) {
+        return;
+    }
+
+    Worker* worker = &(app->game->workers[index]);
+    int spins = 0;
+
+    while (__atomic_load_n(&(worker->done), __ATOMIC_ACQUIRE) < generation) {
+        if (++spins > WAVEFRONT_SPINS) {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * Gets the signature of the cells in a rectangle of a grid
+ */
+uint64_t tile_signature(Grid* grid, int rowStart, int rowEnd, int xStart, int xEnd) {
+    uint64_t signature = 0;
+
+    for (int row = rowStart; row < rowEnd; row++) {
+        signature = s4354198_cycle_mix_cells(signature, 
+            s4354198_grid_row(grid, row) + xStart, xEnd - xStart);
+    }
+
+    return signature;
+}
+
+/**
+ * Steps tiles [start, end) of the sparse universe
+ */
+void sparse_logic(Worker* worker, int start, int end) {
+    SparseWorld* world = app->game->world;
+
+    for (int i = start; i < end; i++) {
+        SparseTile* tile = world->tiles[i];
+        Grid* previous = tile->grids[world->current];
+        Grid* next = tile->grids[1 - world->current];
+
+        s4354198_sparse_fill_halo(world, tile);
+
+        for (int row = 0; row < SPARSE_TILE_SIDE; row++) {
+            s4354198_grid_step_row(previous, next, row);
+            census_span(previous, next, row, 0, SPARSE_TILE_SIDE, worker->index);
+        }
+
+        s4354198_sparse_scan(tile, 1 - world->current);
+        tile->signature = tile->alive[1 - world->current] ? 
+            tile_signature(next, 0, SPARSE_TILE_SIDE, 0, SPARSE_TILE_SIDE) : 0;
+    }
+}
+
+/**
+ * Computes the next generation of one tile. Returns true if anything
+ * in the tile changed.
+ */
+bool tile_logic(Worker* worker, Buffers* buffers, int tileRow, int tileCol) {
+    int rowStart = tileRow * ACTIVITY_TILE_ROWS;
+    int rowEnd = rowStart + ACTIVITY_TILE_ROWS;
+    int xStart = tileCol * ACTIVITY_TILE_COLS;
+    int xEnd = xStart + ACTIVITY_TILE_COLS;
+    int changes = 0;
+
+    if (rowEnd > app->shellArgs->height) {
+        rowEnd = app->shellArgs->height;
+    }
+    if (xEnd > app->shellArgs->width) {
+        xEnd = app->shellArgs->width;
+    }
+
+    switch (app->shellArgs->engine) {
+        case ENGINE_DIRECT:
+            for (int row = rowStart; row < rowEnd; row++) {
+                s4354198_grid_step_span(buffers->from, buffers->to, row, xStart, xEnd);
+                changes += census_span(buffers->from, buffers->to, row, xStart, xEnd, 
+                    worker->index);
+            }
+            break;
+        case ENGINE_BITS:
+            // Tiles are exactly one bit word wide
+            s4354198_bitgrid_step_words(buffers->fromBits, buffers->toBits,
+                rowStart, rowEnd, tileCol, tileCol + 1);
+            for (int row = rowStart; row < rowEnd; row++) {
+                bits_span_ids(buffers, row, xStart, xEnd);
+                changes += census_span(buffers->from, buffers->to, row, xStart, xEnd, 
+                    worker->index);
+            }
+            break;
+        case ENGINE_HASHLIFE:
+        case ENGINE_SPARSE:
+            // Not tiled by activity
+            break;
+    }
+
+    int tile = tileRow * app->game->activity->tileCols + tileCol;
+
+    app->game->activity->signatures[tile] = tile_signature(buffers->to, rowStart, rowEnd, 
+        xStart, xEnd);
+    s4354198_activity_cost(app->game->activity, tile, changes);
+
+    return changes > 0;
+}
+
+/**
+ * Records the owner changes of a freshly computed span of a row in 
+ * the census. Returns the number of cells that changed.
+ */
+int census_span(Grid* previousGrid, Grid* currentGrid, int row, int xStart, int xEnd, 
+        int slot) {
+    CellId* previous = s4354198_grid_row(previousGrid, row);
+    CellId* current = s4354198_grid_row(currentGrid, row);
+
+    // Settled spans are the common case
+    if (memcmp(&previous[xStart], &current[xStart], sizeof(CellId) * (xEnd - xStart)) == 0) {
+        return 0;
+    }
+
+    int changes = 0;
+    for (int i = xStart; i < xEnd; i++) {
+        if (previous[i] != current[i]) {
+            s4354198_census_record(app->game->census, slot, previous[i], current[i]);
+            changes++;
+        }
+    }
+
+    return changes;
+}
+
+/**
+ * Fills in the ids of a span of a row from the bit engine's liveness.
+ * Only live cells need an owner, so the cost follows the population.
+ */
+void bits_span_ids(Buffers* buffers, int row, int xStart, int xEnd) {
+    CellId* myState = s4354198_grid_row(buffers->to, row);
+    uint64_t* words = s4354198_bitgrid_row(buffers->toBits, row);
+    int wordEnd = (xEnd + BITGRID_WORD_BITS - 1) / BITGRID_WORD_BITS;
+
+    memset(&myState[xStart], 0, sizeof(CellId) * (xEnd - xStart));
+
+    for (int k = xStart / BITGRID_WORD_BITS; k < wordEnd; k++) {
+        uint64_t word = words[k + 1];
+
+        while (word != 0) {
+            int i = k * BITGRID_WORD_BITS + __builtin_ctzll(word);
+            CellId id = highest_neighbour(buffers->from, row, i);
+            // Survivors with no neighbours keep their own id
+            myState[i] = (id != 0) ? id : s4354198_grid_row(buffers->from, row)[i];
+            word &= word - 1;
+        }
+    }
+}
+
+/**
+ * Sends the engine statistics to the shell
+ */
+void send_stats(void) {
+    Activity* activity = app->game->activity;
+
+    if (app->game->life != NULL) {
+        Hashlife* life = app->game->life;
+
+        lock_print_to_shell("Generation %lu, rule %s, %s engine, 2^%d generations per step, "
+            "population %llu, %lu nodes cached, %lu collections\n",
+            app->game->generation, app->shellArgs->rule.name, ENGINE_NAME_HASHLIFE, app->shellArgs->stepLog, 
+            (unsigned long long) life->root->population, (unsigned long) life->nodeCount,
+            life->collections);
+        return;
+    }
+
+    if (app->game->shards != NULL) {
+        ShardSet* shards = app->game->shards;
+
+        lock_print_to_shell("Generation %lu, rule %s, %s engine (%s), %d shards of about "
+            "%d rows, population %ld\n",
+            app->game->generation, app->shellArgs->rule.name, ENGINE_NAME_DIRECT, 
+            s4354198_grid_kernel_name(), shards->count, shards->height / shards->count,
+            app->game->census->population);
+        return;
+    }
+
+    if (app->game->world != NULL) {
+        SparseWorld* world = app->game->world;
+        // Two haloed grids per tile
+        double megabytes = (world->tileCount * 2.0 * sizeof(CellId) * 
+            (SPARSE_TILE_SIDE + 2) * (SPARSE_TILE_SIDE + 2)) / (1024 * 1024);
+
+        lock_print_to_shell("Generation %lu, rule %s, %s engine (%s), %d workers "
+            "(%lu tiles stolen), %d tiles (%.1fMB), view at (%d, %d)\n",
+            app->game->generation, app->shellArgs->rule.name, ENGINE_NAME_SPARSE, s4354198_grid_kernel_name(),
+            app->game->workerCount, stolen_tiles(), world->tileCount, megabytes, 
+            app->game->viewX, app->game->viewY);
+        return;
+    }
+
+    int tiles = activity->tileRows * activity->tileCols;
+    const char* kernel = (app->shellArgs->engine == ENGINE_BITS) ?
+        s4354198_bitgrid_kernel_name() : s4354198_grid_kernel_name();
+
+    lock_print_to_shell("Generation %lu, rule %s, %s engine (%s), %d workers "
+        "(%lu tiles stolen), %d/%d tiles active (%.1f%%)\n",
+        app->game->generation, app->shellArgs->rule.name, s4354198_engine_name(app->shellArgs->engine),
+        kernel, app->game->workerCount, stolen_tiles(), activity->activeCount, tiles,
+        (100.0 * activity->activeCount) / tiles);
+}
+
+/**
+ * Sends how well the game loop is keeping to its refresh rate to the shell
+ */
+void send_tick_stats(void) {
+    // Every universe is paced by the default one's ticker
+    Ticker* ticker = universes[0]->ticker;
+
+    if (ticker->period == 0) {
+        lock_print_to_shell("Running unthrottled, %lu ticks\n", ticker->ticks);
+        return;
+    }
+
+    lock_print_to_shell("Ticking every %dms, %lu of %lu deadlines missed (worst by %.1fms)\n", 
+        app->shellArgs->refreshRate, ticker->missed, ticker->ticks, 
+        ticker->worstLate / (double) TICKER_MILLISECOND);
+}
+
+/**
+ * Sends what the cycle detector knows to the shell, if the board has
+ * settled
+ */
+void send_cycle_stats(void) {
+    Cycle* cycle = app->game->cycle;
+
+    if (!s4354198_cycle_settled(cycle)) {
+        return;
+    }
+
+    lock_print_to_shell("Settled since generation %lu with period %lu, %s\n",
+        cycle->startGeneration, cycle->period, 
+        s4354198_cycle_can_idle(cycle) ? "replaying from the cache" : "still computing");
+}
+
+/**
+ * Sends how far back the board can be rewound to the shell
+ */
+void send_history_stats(void) {
+    History* history = app->game->history;
+
+    if (history == NULL) {
+        return;
+    }
+
+    if (app->game->life != NULL) {
+        Hashlife* life = app->game->life;
+
+        if (life->pastCount > 0) {
+            lock_print_to_shell("History from generation %llu, %d roots kept\n", 
+                (unsigned long long) life->pastGenerations[life->pastFirst], 
+                life->pastCount);
+        }
+        return;
+    }
+
+    if (history->count > 0) {
+        lock_print_to_shell("History from generation %lu, %d generations in %d keyframes "
+            "(%.1fMB of %dMB)\n", history->entries[0].generation, history->count,
+            s4354198_history_keyframes(history), history->bytes / (1024.0 * 1024), 
+            app->shellArgs->historyMegabytes);
+    }
+}
+
+/**
+ * Get the value of the highest neighbour
+ */
+CellId highest_neighbour(Grid* grid, int row, int i) {
+    CellId* above = s4354198_grid_row(grid, row - 1);
+    CellId* current = s4354198_grid_row(grid, row);
+    CellId* below = s4354198_grid_row(grid, row + 1);
+
+    // All the neighbours, the ghost border covers the edges
+    CellId ids[8] = {
+        above[i - 1], above[i], above[i + 1],
+        current[i - 1], current[i + 1],
+        below[i - 1], below[i], below[i + 1]
     };
 
-    // Check each coord
+    CellId max = 0;
     for (int j = 0; j < 8; j++) {
-        int y = pairs[j][0];
-        int x = pairs[j][1];
-
-        if (safe_coords(y, x)) {
-            int id = state[y][x];
-            
-            if (id > max) {
-                max = id;
+        max = ids[j] > max ? ids[j] : max;
+    }
+
+    return max;
+}
+
+/**
+ * Benchmarks every engine and kernel from the same starting board and 
+ * prints the timings as JSON, then tunes the temporal block depth. Each 
+ * one runs in its own child, so they all start from a fresh process. 
+ * Returns non zero if any of them disagree.
+ */
+int run_bench(void) {
+    EngineType engines[] = {ENGINE_DIRECT, ENGINE_BITS, ENGINE_SPARSE, ENGINE_HASHLIFE};
+    int kernelCount = sizeof(benchKernels) / sizeof(benchKernels[0]);
+    // Bounded and unbounded engines only agree until something reaches the
+    // edge, so each is compared against the first run of its own kind
+    BenchResult baselines[2];
+    bool haveBaseline[2] = {false, false};
+    bool identical = true;
+    bool first = true;
+    // Only asked for runs are split between processes
+    int shards = app->shellArgs->shards;
+
+    app->shellArgs->shards = 0;
+    benchStart = bench_seed();
+
+    printf("{\"width\": %d, \"height\": %d, \"generations\": %lu, \"rule\": ",
+        app->shellArgs->width, app->shellArgs->height, app->shellArgs->benchGenerations);
+    print_json_string(app->shellArgs->rule.name);
+    printf(", \"torus\": %s, \"seed\": {", app->shellArgs->torus ? "true" : "false");
+    if (app->shellArgs->benchPattern != NULL) {
+        printf("\"pattern\": ");
+        print_json_string(app->shellArgs->benchPattern);
+    } else {
+        printf("\"density\": %d, \"seed\": %u", app->shellArgs->benchDensity, 
+            app->shellArgs->benchSeed);
+    }
+    printf(", \"width\": %d, \"height\": %d}, \"runs\": [", benchStart->width, 
+        benchStart->height);
+
+    for (int i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        EngineType engine = engines[i];
+        int bounded = (engine == ENGINE_DIRECT || engine == ENGINE_BITS) ? 1 : 0;
+
+        if (!bounded && app->shellArgs->torus) {
+            continue;
+        }
+
+        // Hashlife has no row kernels to choose between
+        int kernels = (engine == ENGINE_HASHLIFE) ? 1 : kernelCount;
+        for (int k = 0; k < kernels; k++) {
+            const char* kernel = (engine == ENGINE_HASHLIFE) ? NULL : benchKernels[k];
+            BenchResult result;
+
+            if (!bench_child(engine, kernel, 0, &result)) {
+                s4354198_exit(1, "\nBenchmark of the %s engine died\n", 
+                    s4354198_engine_name(engine));
+            }
+
+            bool matches = true;
+            if (result.supported && haveBaseline[bounded]) {
+                matches = result.signature == baselines[bounded].signature &&
+                    result.population == baselines[bounded].population;
+            } else if (result.supported) {
+                baselines[bounded] = result;
+                haveBaseline[bounded] = true;
             }
+            identical = identical && matches;
+
+            printf("%s\n    ", first ? "" : ",");
+            print_bench_result(&result, matches);
+            fflush(stdout);
+            first = false;
         }
     }
 
-    return max;
+    // A sharded board should step the same as the direct engine in one piece
+    if (shards > 1) {
+        BenchResult result;
+
+        app->shellArgs->shards = shards;
+        if (!bench_child(ENGINE_DIRECT, NULL, 0, &result)) {
+            s4354198_exit(1, "\nBenchmark of %d shards died\n", shards);
+        }
+        app->shellArgs->shards = 0;
+
+        bool matches = result.signature == baselines[1].signature &&
+            result.population == baselines[1].population;
+        identical = identical && matches;
+
+        printf("%s\n    ", first ? "" : ",");
+        print_bench_result(&result, matches);
+        fflush(stdout);
+    }
+
+    printf("\n], \"blocking\": [");
+    // Blocking is only for the bounded engines without wrapping
+    if (haveBaseline[1] && !app->shellArgs->torus) {
+        bench_depths(&baselines[1]);
+        identical = identical && baselines[1].supported;
+    } else {
+        printf("], \"bestDepth\": {}");
+    }
+
+    printf(", \"identical\": %s}\n", identical ? "true" : "false");
+
+    return identical ? 0 : 2;
+}
+
+/**
+ * Times fast forwards with each temporal block depth on the bounded 
+ * engines and picks the quickest depth for each, to pass to -T. Clears 
+ * the baseline's supported flag if any of them disagree with it.
+ */
+void bench_depths(BenchResult* baseline) {
+    EngineType engines[] = {ENGINE_DIRECT, ENGINE_BITS};
+    int depthCount = sizeof(benchDepths) / sizeof(benchDepths[0]);
+    int best[2] = {1, 1};
+    bool first = true;
+
+    for (int i = 0; i < 2; i++) {
+        double bestSeconds = 0;
+
+        for (int d = 0; d < depthCount; d++) {
+            BenchResult result;
+
+            if (!bench_child(engines[i], NULL, benchDepths[d], &result)) {
+                s4354198_exit(1, "\nBenchmark of the %s engine died\n", 
+                    s4354198_engine_name(engines[i]));
+            }
+
+            bool matches = result.signature == baseline->signature && 
+                result.population == baseline->population;
+            if (!matches) {
+                baseline->supported = false;
+            } else if (d == 0 || result.stepSeconds < bestSeconds) {
+                best[i] = benchDepths[d];
+                bestSeconds = result.stepSeconds;
+            }
+
+            printf("%s\n    ", first ? "" : ",");
+            print_bench_result(&result, matches);
+            fflush(stdout);
+            first = false;
+        }
+    }
+
+    printf("\n], \"bestDepth\": {\"%s\": %d, \"%s\": %d}", ENGINE_NAME_DIRECT, best[0],
+        ENGINE_NAME_BITS, best[1]);
+}
+
+/**
+ * Gets the starting board, either the pattern given or a random soup 
+ * filling the board
+ */
+Pattern* bench_seed(void) {
+    if (app->shellArgs->benchPattern != NULL) {
+        const char* error = NULL;
+        Pattern* pattern = s4354198_pattern_load(app->shellArgs->benchPattern, &error);
+
+        if (pattern == NULL) {
+            s4354198_exit(1, "Unable to load %s: %s\n", app->shellArgs->benchPattern, error);
+        }
+
+        return pattern;
+    }
+
+    Pattern* soup = s4354198_pattern_create(app->shellArgs->width, app->shellArgs->height);
+    if (soup == NULL) {
+        s4354198_exit(1, "Unable to allocate the soup\n");
+    }
+
+    unsigned int seed = app->shellArgs->benchSeed;
+    for (int y = 0; y < soup->height; y++) {
+        uint64_t* row = s4354198_pattern_row(soup, y);
+
+        for (int x = 0; x < soup->width; x++) {
+            if (rand_r(&seed) % 100 < app->shellArgs->benchDensity) {
+                row[x / PATTERN_WORD_BITS] |= 1ULL << (x % PATTERN_WORD_BITS);
+            }
+        }
+    }
+
+    return soup;
+}
+
+/**
+ * Benchmarks one engine and kernel in a child process. Returns false if
+ * the child died before reporting back.
+ */
+bool bench_child(EngineType engine, const char* kernel, int depth, BenchResult* result) {
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        return false;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        bench_engine(engine, kernel, depth, result);
+        // Smaller than PIPE_BUF, so this is written in one go
+        if (write(fds[1], result, sizeof(BenchResult)) != sizeof(BenchResult)) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+
+    size_t got = 0;
+    ssize_t count;
+    while (got < sizeof(BenchResult) && 
+            (count = read(fds[0], (char*) result + got, sizeof(BenchResult) - got)) > 0) {
+        got += count;
+    }
+
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+
+    return got == sizeof(BenchResult);
+}
+
+/**
+ * Runs the benchmark generations on one engine and kernel, timing each
+ * phase of a tick the way the game loop runs it. Given a temporal block
+ * depth they are run as one fast forward instead, with the kernel left to
+ * the CPU.
+ */
+void bench_engine(EngineType engine, const char* kernel, int depth, BenchResult* result) {
+    memset(result, 0, sizeof(BenchResult));
+    result->engine = engine;
+    result->kernel = kernel;
+    result->depth = depth;
+    result->supported = true;
+
+    if (kernel != NULL) {
+        result->supported = (engine == ENGINE_BITS) ? s4354198_bitgrid_use_kernel(kernel) :
+            s4354198_grid_use_kernel(kernel);
+        if (!result->supported) {
+            return;
+        }
+    }
+
+    app->shellArgs->engine = engine;
+    app->shellArgs->stepLog = 0;
+    app->shellArgs->temporalDepth = depth;
+
+    create_headless_comms();
+    create_semaphores();
+    create_game(UNIVERSE_DEFAULT);
+    pthread_create(&frameOutput, NULL, &frame_out_handler, NULL);
+    result->workers = app->game->workerCount;
+    if (app->game->shards != NULL) {
+        result->shards = app->game->shards->count;
+        result->kernel = s4354198_grid_kernel_name();
+    }
+
+    double start = bench_clock();
+
+    LifeForm* lifeForm = (LifeForm*) malloc(sizeof(LifeForm));
+    lifeForm->id = BENCH_SOUP_ID;
+    lifeForm->x = (app->shellArgs->width - benchStart->width) / 2 + 1;
+    lifeForm->y = (app->shellArgs->height - benchStart->height) / 2 + 1;
+    lifeForm->lifeType = PATTERN;
+    lifeForm->formType = IMPORTED;
+    lifeForm->pattern = benchStart;
+    s4354198_queue_push(app->game->newLifeForms, &(lifeForm->node));
+    add_new_life_forms();
+
+    double stepped = bench_clock();
+    result->seedSeconds = stepped - start;
+
+    if (depth > 0) {
+        result->kernel = (engine == ENGINE_BITS) ? s4354198_bitgrid_kernel_name() : 
+            s4354198_grid_kernel_name();
+        fast_forward(app->shellArgs->benchGenerations);
+        result->stepSeconds = bench_clock() - stepped;
+        bench_signature(result);
+        return;
+    }
+
+    for (unsigned long i = 0; i < app->shellArgs->benchGenerations; i++) {
+        step_generation();
+        double observed = bench_clock();
+
+        observe_cycle();
+        double sent = bench_clock();
+
+        send_to_display();
+        double finished = bench_clock();
+
+        result->stepSeconds += observed - stepped;
+        result->cycleSeconds += sent - observed;
+        result->frameSeconds += finished - sent;
+        stepped = finished;
+    }
+
+    bench_signature(result);
+}
+
+/**
+ * Signs the final board as the display sees it, so engines that hold 
+ * their cells differently can still be compared
+ */
+void bench_signature(BenchResult* result) {
+    Snapshot* snapshot = app->game->snapshot;
+    FrameWriter* frame = app->game->frame;
+    int id;
+    int count;
+
+    // Built here, once the frame thread is done with the last one
+    sem_wait(&snapshotFree);
+    capture_snapshot(snapshot);
+    s4354198_snapshot_write(snapshot, frame);
+    char* cursor = s4354198_frame_writer_finish(frame);
+
+    while (s4354198_frame_next(&cursor, &id, &count)) {
+        result->signature = s4354198_cycle_mix(result->signature, 
+            ((uint64_t) id << 32) | (uint32_t) count);
+        if (id != 0) {
+            result->population += count;
+        }
+    }
+}
+
+/**
+ * Points everything cag would send at /dev/null. Nothing is read, as the
+ * threads that read are never started.
+ */
+void create_headless_comms(void) {
+    app->comms = (Comms*) malloc(sizeof(Comms));
+    app->comms->fromShell = NULL;
+    app->comms->fromDisplay = NULL;
+    app->comms->toShell = fopen("/dev/null", "w");
+    app->comms->toDisplay = fopen("/dev/null", "w");
+    app->comms->toRecord = fopen("/dev/null", "w");
+
+    if (app->comms->toShell == NULL || app->comms->toDisplay == NULL || 
+            app->comms->toRecord == NULL) {
+        s4354198_exit(1, "Unable to open /dev/null\n");
+    }
+}
+
+/**
+ * Gets a monotonic time in seconds
+ */
+double bench_clock(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / (double) TICKER_NANOSECONDS;
+}
+
+/**
+ * Prints one benchmark result as a JSON object
+ */
+void print_bench_result(BenchResult* result, bool matches) {
+    printf("{\"engine\": \"%s\", \"kernel\": ", s4354198_engine_name(result->engine));
+    if (result->kernel != NULL) {
+        print_json_string(result->kernel);
+    } else {
+        printf("null");
+    }
+
+    if (!result->supported) {
+        printf(", \"supported\": false}");
+        return;
+    }
+
+    double generations = (double) app->shellArgs->benchGenerations;
+    double cells = generations * app->shellArgs->width * app->shellArgs->height;
+    double total = result->stepSeconds + result->cycleSeconds + result->frameSeconds;
+
+    if (result->depth > 0) {
+        printf(", \"depth\": %d", result->depth);
+    }
+    if (result->shards > 0) {
+        printf(", \"shards\": %d", result->shards);
+    }
+
+    printf(", \"supported\": true, \"workers\": %d, \"seconds\": %.6f, "
+        "\"generationsPerSecond\": %.1f, \"cellsPerSecond\": %.0f, "
+        "\"phases\": {\"seed\": %.6f, \"step\": %.6f, \"cycle\": %.6f, \"frame\": %.6f}, "
+        "\"population\": %lu, \"signature\": \"%016llx\", \"matches\": %s}",
+        result->workers, total, 
+        (result->stepSeconds > 0) ? generations / result->stepSeconds : 0.0,
+        (result->stepSeconds > 0) ? cells / result->stepSeconds : 0.0,
+        result->seedSeconds, result->stepSeconds, result->cycleSeconds, 
+        result->frameSeconds, result->population, 
+        (unsigned long long) result->signature, matches ? "true" : "false");
+}
+
+/**
+ * Prints text as a quoted JSON string
+ */
+void print_json_string(const char* text) {
+    putchar('"');
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            putchar('\\');
+            putchar(*c);
+        } else if ((unsigned char) *c < ' ') {
+            printf("\\u%04x", *c);
+        } else {
+            putchar(*c);
+        }
+    }
+    putchar('"');
 }
\ No newline at end of file
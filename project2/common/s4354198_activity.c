@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "s4354198_activity.h"
+#include "s4354198_cycle.h"
+
+/**
+ * Creates the activity tracking for a board, with every tile active. When
+ * wrap is set the tiles on opposite edges are neighbours.
+ */
+Activity* s4354198_activity_create(int width, int height, bool wrap) {
+    Activity* activity = (Activity*) malloc(sizeof(Activity));
+    activity->wrap = wrap;
+    activity->tileRows = (height + ACTIVITY_TILE_ROWS - 1) / ACTIVITY_TILE_ROWS;
+    activity->tileCols = (width + ACTIVITY_TILE_COLS - 1) / ACTIVITY_TILE_COLS;
+
+    int tiles = activity->tileRows * activity->tileCols;
+    activity->changed = (bool*) malloc(sizeof(bool) * tiles);
+    activity->spare = (bool*) calloc(tiles, sizeof(bool));
+    activity->active = (bool*) malloc(sizeof(bool) * tiles);
+    activity->signatures = (uint64_t*) calloc(tiles, sizeof(uint64_t));
+    activity->costs = (int*) malloc(sizeof(int) * tiles);
+    activity->activeCount = tiles;
+    activity->activeCost = (long) tiles * ACTIVITY_BASE_COST;
+    for (int i = 0; i < tiles; i++) {
+        activity->costs[i] = ACTIVITY_BASE_COST;
+    }
+    s4354198_activity_mark_all(activity);
+
+    return activity;
+}
+
+/**
+ * Marks the tile holding a cell as changed, as when it is drawn on
+ */
+void s4354198_activity_mark(Activity* activity, int y, int x) {
+    int tile = (y / ACTIVITY_TILE_ROWS) * activity->tileCols + x / ACTIVITY_TILE_COLS;
+
+    activity->changed[tile] = true;
+}
+
+/**
+ * Marks every tile as changed
+ */
+void s4354198_activity_mark_all(Activity* activity) {
+    int tiles = activity->tileRows * activity->tileCols;
+
+    memset(activity->changed, true, sizeof(bool) * tiles);
+}
+
+/**
+ * Records how many cells changed when a tile was last computed, as the 
+ * estimate of what it will cost next time
+ */
+void s4354198_activity_cost(Activity* activity, int tile, int changes) {
+    activity->costs[tile] = ACTIVITY_BASE_COST + changes;
+}
+
+/**
+ * Works out which tiles need computing this generation from the tiles
+ * that changed last generation, and starts afresh for recording the
+ * changes of this one. Returns the number of active tiles.
+ */
+int s4354198_activity_plan(Activity* activity) {
+    int rows = activity->tileRows;
+    int cols = activity->tileCols;
+
+    activity->activeCount = 0;
+    activity->activeCost = 0;
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            bool active = s4354198_activity_due(activity, activity->changed, i, j);
+
+            activity->active[i * cols + j] = active;
+            activity->activeCount += active;
+            activity->activeCost += active ? activity->costs[i * cols + j] : 0;
+        }
+    }
+
+    memset(activity->changed, false, sizeof(bool) * rows * cols);
+
+    return activity->activeCount;
+}
+
+/**
+ * Checks if a tile needs computing given which tiles changed the
+ * generation before, that is if it or one of its neighbours did
+ */
+bool s4354198_activity_due(Activity* activity, const bool* changed, int tileRow, 
+        int tileCol) {
+    int rows = activity->tileRows;
+    int cols = activity->tileCols;
+
+    for (int i = tileRow - 1; i <= tileRow + 1; i++) {
+        for (int j = tileCol - 1; j <= tileCol + 1; j++) {
+            int y = activity->wrap ? (i + rows) % rows : i;
+            int x = activity->wrap ? (j + cols) % cols : j;
+
+            if (y >= 0 && y < rows && x >= 0 && x < cols && changed[y * cols + x]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Combines the tile signatures into one for the whole board
+ */
+uint64_t s4354198_activity_signature(Activity* activity) {
+    int tiles = activity->tileRows * activity->tileCols;
+    uint64_t signature = 0;
+
+    for (int i = 0; i < tiles; i++) {
+        signature = s4354198_cycle_mix(signature, activity->signatures[i]);
+    }
+
+    return signature;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines */
+// Tiles are a whole number of bit words wide so both engines can skip them
+#define ACTIVITY_TILE_ROWS 16
+#define ACTIVITY_TILE_COLS 64
+// Estimated cost of computing a tile in which nothing changes, counted in 
+// changed cells
+#define ACTIVITY_BASE_COST 64
+
+/*
+ * Tracks which tiles of the board changed last generation. A tile only
+ * needs computing when it or one of its eight neighbours changed, as
+ * otherwise both generation buffers already hold its next state.
+ */
+typedef struct {
+    int tileRows;
+    int tileCols;
+    bool wrap;
+    bool* changed;
+    // Second set of changed flags, for when generations are computed as a
+    // wavefront and each generation's flags are read while the next are set
+    bool* spare;
+    bool* active;
+    int activeCount;
+    // Estimated cost of each tile, from the cells that changed the last 
+    // time it was computed, and the total over the active tiles
+    int* costs;
+    long activeCost;
+    // Signature of each tile's cells as of the last time it was computed
+    uint64_t* signatures;
+} Activity;
+
+/* Function prototypes */
+Activity* s4354198_activity_create(int width, int height, bool wrap);
+void s4354198_activity_mark(Activity* activity, int y, int x);
+void s4354198_activity_mark_all(Activity* activity);
+void s4354198_activity_cost(Activity* activity, int tile, int changes);
+int s4354198_activity_plan(Activity* activity);
+bool s4354198_activity_due(Activity* activity, const bool* changed, int tileRow, 
+    int tileCol);
+uint64_t s4354198_activity_signature(Activity* activity);
+
+#endif
\ No newline at end of file
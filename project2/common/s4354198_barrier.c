@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "s4354198_barrier.h"
+
+/**
+ * Hint to the CPU that we are in a spin loop
+ */
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/**
+ * Initialises a barrier for the given number of threads
+ */
+void s4354198_barrier_init(Barrier* barrier, int parties) {
+    barrier->parties = parties;
+    barrier->waiting = 0;
+    barrier->generation = 0;
+    pthread_mutex_init(&barrier->lock, NULL);
+    pthread_cond_init(&barrier->wake, NULL);
+}
+
+/**
+ * Waits until all parties have arrived at the barrier. Waiters spin
+ * for a short while first, as generations are usually short, and only
+ * then fall back to sleeping on the condition variable.
+ */
+void s4354198_barrier_wait(Barrier* barrier) {
+    unsigned int generation = __atomic_load_n(&barrier->generation, __ATOMIC_ACQUIRE);
+
+    // Last one in releases everybody else
+    if (__atomic_add_fetch(&barrier->waiting, 1, __ATOMIC_ACQ_REL) == barrier->parties) {
+        __atomic_store_n(&barrier->waiting, 0, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&barrier->lock);
+        __atomic_store_n(&barrier->generation, generation + 1, __ATOMIC_RELEASE);
+        pthread_cond_broadcast(&barrier->wake);
+        pthread_mutex_unlock(&barrier->lock);
+        return;
+    }
+
+    for (int i = 0; i < BARRIER_SPINS; i++) {
+        if (__atomic_load_n(&barrier->generation, __ATOMIC_ACQUIRE) != generation) {
+            return;
+        }
+        cpu_relax();
+    }
+
+    pthread_mutex_lock(&barrier->lock);
+    while (__atomic_load_n(&barrier->generation, __ATOMIC_ACQUIRE) == generation) {
+        pthread_cond_wait(&barrier->wake, &barrier->lock);
+    }
+    pthread_mutex_unlock(&barrier->lock);
+}
+
+/**
+ * Releases the resources held by a barrier
+ */
+void s4354198_barrier_destroy(Barrier* barrier) {
+    pthread_mutex_destroy(&barrier->lock);
+    pthread_cond_destroy(&barrier->wake);
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <pthread.h>
+
+/* Defines */
+// Number of polls a waiter makes before it blocks on the condition variable
+#define BARRIER_SPINS 4000
+
+typedef struct {
+    int parties;
+    int waiting;
+    unsigned int generation;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} Barrier;
+
+/* Function prototypes */
+void s4354198_barrier_init(Barrier* barrier, int parties);
+void s4354198_barrier_wait(Barrier* barrier);
+void s4354198_barrier_destroy(Barrier* barrier);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,400 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s4354198_bitgrid.h"
+
+/* Vector types used by the wide kernels */
+typedef uint64_t Vec2 __attribute__((vector_size(16)));
+typedef uint64_t Vec4 __attribute__((vector_size(32)));
+
+/* Signature shared by all the row kernels */
+typedef void (*StepRow)(const uint64_t* above, const uint64_t* row,
+    const uint64_t* below, uint64_t* out, int words);
+
+/* Function prototypes */
+static void select_kernel(void);
+static void step_row_scalar(const uint64_t* above, const uint64_t* row,
+    const uint64_t* below, uint64_t* out, int words);
+static void step_row_rule_scalar(const uint64_t* above, const uint64_t* row,
+    const uint64_t* below, uint64_t* out, int words);
+
+/* Globals */
+// Row kernel picked for this CPU and rule
+static StepRow stepRow = NULL;
+// Name of the picked kernel
+static const char* stepRowName = "scalar";
+// Every kernel from narrowest to widest
+static const char* kernelNames[] = {"scalar", "sse2", "avx2"};
+// Index into kernelNames of the widest kernel that may be picked
+static int widestKernel = 2;
+// Whether the rule is B3/S23 and can use the Conway kernels
+static bool conway = true;
+// Per neighbour count words of the rule, all ones where a cell lives
+static uint64_t birthWords[RULE_MAX_NEIGHBOURS + 1];
+static uint64_t surviveWords[RULE_MAX_NEIGHBOURS + 1];
+
+/*
+ * Bit-sliced Conway step over whole words. The eight neighbour planes are
+ * summed with full adders into ones/twos/fours/eights planes, and a cell is
+ * alive next generation when the count is 3, or 2 and it is already alive.
+ */
+#define LIFE_LOGIC(T, aw, a, ae, sw, s, se, bw, b, be, result) do { \
+    T upperSum = aw ^ a ^ ae; \
+    T upperCarry = (aw & a) | (ae & (aw ^ a)); \
+    T middleSum = sw ^ se; \
+    T middleCarry = sw & se; \
+    T lowerSum = bw ^ b ^ be; \
+    T lowerCarry = (bw & b) | (be & (bw ^ b)); \
+    T ones = upperSum ^ middleSum ^ lowerSum; \
+    T onesCarry = (upperSum & middleSum) | (lowerSum & (upperSum ^ middleSum)); \
+    T twosPartial = upperCarry ^ middleCarry ^ lowerCarry; \
+    T foursPartial = (upperCarry & middleCarry) | (lowerCarry & (upperCarry ^ middleCarry)); \
+    T twos = twosPartial ^ onesCarry; \
+    T fours = foursPartial | (twosPartial & onesCarry); \
+    result = ~fours & twos & (ones | s); \
+} while (0)
+
+/*
+ * Bit-sliced step for any rule. The adders are carried through to the
+ * full four bit count, then each count the rule cares about is matched
+ * against its birth or survive word. The loop over counts is unrolled by
+ * the compiler, so there are no branches on cell data.
+ */
+#define RULE_LOGIC(T, aw, a, ae, sw, s, se, bw, b, be, result) do { \
+    T upperSum = aw ^ a ^ ae; \
+    T upperCarry = (aw & a) | (ae & (aw ^ a)); \
+    T middleSum = sw ^ se; \
+    T middleCarry = sw & se; \
+    T lowerSum = bw ^ b ^ be; \
+    T lowerCarry = (bw & b) | (be & (bw ^ b)); \
+    T ones = upperSum ^ middleSum ^ lowerSum; \
+    T onesCarry = (upperSum & middleSum) | (lowerSum & (upperSum ^ middleSum)); \
+    T twosPartial = upperCarry ^ middleCarry ^ lowerCarry; \
+    T foursPartial = (upperCarry & middleCarry) | (lowerCarry & (upperCarry ^ middleCarry)); \
+    T twos = twosPartial ^ onesCarry; \
+    T twosCarry = twosPartial & onesCarry; \
+    T fours = foursPartial ^ twosCarry; \
+    T eights = foursPartial & twosCarry; \
+    T lives = ones & 0; \
+    for (int n = 0; n <= RULE_MAX_NEIGHBOURS; n++) { \
+        T match = ((n & 1) ? ones : ~ones) & ((n & 2) ? twos : ~twos) & \
+            ((n & 4) ? fours : ~fours) & ((n & 8) ? eights : ~eights); \
+        lives |= match & ((s & surviveWords[n]) | (~s & birthWords[n])); \
+    } \
+    result = lives; \
+} while (0)
+
+/*
+ * Defines a row kernel that handles LANES words per iteration using the
+ * vector type T, finishing any remainder with the scalar kernel.
+ */
+#define DEFINE_STEP_ROW(name, T, LANES, attributes) \
+    DEFINE_STEP_ROW_LOGIC(name, T, LANES, attributes, LIFE_LOGIC, step_row_scalar)
+#define DEFINE_STEP_ROW_LOGIC(name, T, LANES, attributes, LOGIC, scalar) \
+attributes static void name(const uint64_t* above, const uint64_t* row, \
+        const uint64_t* below, uint64_t* out, int words) { \
+    int k = 1; \
+    for (; k + LANES - 1 <= words; k += LANES) { \
+        T a, ap, an, s, sp, sn, b, bp, bn, result; \
+        memcpy(&a, above + k, sizeof(T)); \
+        memcpy(&ap, above + k - 1, sizeof(T)); \
+        memcpy(&an, above + k + 1, sizeof(T)); \
+        memcpy(&s, row + k, sizeof(T)); \
+        memcpy(&sp, row + k - 1, sizeof(T)); \
+        memcpy(&sn, row + k + 1, sizeof(T)); \
+        memcpy(&b, below + k, sizeof(T)); \
+        memcpy(&bp, below + k - 1, sizeof(T)); \
+        memcpy(&bn, below + k + 1, sizeof(T)); \
+        T aw = (a << 1) | (ap >> 63); \
+        T ae = (a >> 1) | (an << 63); \
+        T sw = (s << 1) | (sp >> 63); \
+        T se = (s >> 1) | (sn << 63); \
+        T bw = (b << 1) | (bp >> 63); \
+        T be = (b >> 1) | (bn << 63); \
+        LOGIC(T, aw, a, ae, sw, s, se, bw, b, be, result); \
+        memcpy(out + k, &result, sizeof(T)); \
+    } \
+    if (k <= words) { \
+        scalar(above + k - 1, row + k - 1, below + k - 1, \
+            out + k - 1, words - k + 1); \
+    } \
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+DEFINE_STEP_ROW(step_row_sse2, Vec2, 2, __attribute__((target("sse2"))))
+DEFINE_STEP_ROW(step_row_avx2, Vec4, 4, __attribute__((target("avx2"))))
+DEFINE_STEP_ROW_LOGIC(step_row_rule_sse2, Vec2, 2, __attribute__((target("sse2"))), 
+    RULE_LOGIC, step_row_rule_scalar)
+DEFINE_STEP_ROW_LOGIC(step_row_rule_avx2, Vec4, 4, __attribute__((target("avx2"))), 
+    RULE_LOGIC, step_row_rule_scalar)
+#endif
+
+/**
+ * Steps a single row one word at a time
+ */
+static void step_row_scalar(const uint64_t* above, const uint64_t* row,
+        const uint64_t* below, uint64_t* out, int words) {
+    for (int k = 1; k <= words; k++) {
+        uint64_t a = above[k];
+        uint64_t s = row[k];
+        uint64_t b = below[k];
+        uint64_t aw = (a << 1) | (above[k - 1] >> 63);
+        uint64_t ae = (a >> 1) | (above[k + 1] << 63);
+        uint64_t sw = (s << 1) | (row[k - 1] >> 63);
+        uint64_t se = (s >> 1) | (row[k + 1] << 63);
+        uint64_t bw = (b << 1) | (below[k - 1] >> 63);
+        uint64_t be = (b >> 1) | (below[k + 1] << 63);
+        uint64_t result;
+
+        LIFE_LOGIC(uint64_t, aw, a, ae, sw, s, se, bw, b, be, result);
+        out[k] = result;
+    }
+}
+
+/**
+ * Steps a single row one word at a time under any rule
+ */
+static void step_row_rule_scalar(const uint64_t* above, const uint64_t* row,
+        const uint64_t* below, uint64_t* out, int words) {
+    for (int k = 1; k <= words; k++) {
+        uint64_t a = above[k];
+        uint64_t s = row[k];
+        uint64_t b = below[k];
+        uint64_t aw = (a << 1) | (above[k - 1] >> 63);
+        uint64_t ae = (a >> 1) | (above[k + 1] << 63);
+        uint64_t sw = (s << 1) | (row[k - 1] >> 63);
+        uint64_t se = (s >> 1) | (row[k + 1] << 63);
+        uint64_t bw = (b << 1) | (below[k - 1] >> 63);
+        uint64_t be = (b >> 1) | (below[k + 1] << 63);
+        uint64_t result;
+
+        RULE_LOGIC(uint64_t, aw, a, ae, sw, s, se, bw, b, be, result);
+        out[k] = result;
+    }
+}
+
+/**
+ * Picks the widest row kernel the CPU supports for the current rule
+ */
+static void select_kernel(void) {
+    if (stepRow != NULL) {
+        return;
+    }
+
+    stepRow = conway ? &step_row_scalar : &step_row_rule_scalar;
+    stepRowName = "scalar";
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (widestKernel >= 2 && __builtin_cpu_supports("avx2")) {
+        stepRow = conway ? &step_row_avx2 : &step_row_rule_avx2;
+        stepRowName = "avx2";
+    } else if (widestKernel >= 1 && __builtin_cpu_supports("sse2")) {
+        stepRow = conway ? &step_row_sse2 : &step_row_rule_sse2;
+        stepRowName = "sse2";
+    }
+#endif
+}
+
+/**
+ * Sets the rule every bit grid is stepped with. Must not be called while
+ * a grid is being stepped.
+ */
+void s4354198_bitgrid_set_rule(const Rule* rule) {
+    conway = s4354198_rule_is_conway(rule);
+
+    for (int n = 0; n <= RULE_MAX_NEIGHBOURS; n++) {
+        birthWords[n] = rule->table[0][n] ? ~0ULL : 0;
+        surviveWords[n] = rule->table[1][n] ? ~0ULL : 0;
+    }
+
+    stepRow = NULL;
+    select_kernel();
+}
+
+/**
+ * Creates an empty bit grid of the given size
+ */
+BitGrid* s4354198_bitgrid_create(int width, int height) {
+    select_kernel();
+
+    BitGrid* grid = (BitGrid*) malloc(sizeof(BitGrid));
+    grid->width = width;
+    grid->height = height;
+    grid->words = (width + BITGRID_WORD_BITS - 1) / BITGRID_WORD_BITS;
+    // Guard word either side, rounded up to a cache line
+    grid->stride = ((grid->words + 2 + 7) / 8) * 8;
+
+    size_t bytes = sizeof(uint64_t) * grid->stride * (height + 2);
+    if (posix_memalign((void**) &(grid->cells), BITGRID_ALIGN, bytes) != 0) {
+        free(grid);
+        return NULL;
+    }
+    memset(grid->cells, 0, bytes);
+
+    return grid;
+}
+
+/**
+ * Frees a bit grid
+ */
+void s4354198_bitgrid_free(BitGrid* grid) {
+    free(grid->cells);
+    free(grid);
+}
+
+/**
+ * Kills every cell in the grid
+ */
+void s4354198_bitgrid_clear(BitGrid* grid) {
+    memset(grid->cells, 0, sizeof(uint64_t) * grid->stride * (grid->height + 2));
+}
+
+/**
+ * Gets the start of a row, where index 1 holds the first 64 cells
+ */
+uint64_t* s4354198_bitgrid_row(BitGrid* grid, int y) {
+    return &(grid->cells[(y + 1) * grid->stride]);
+}
+
+/**
+ * Sets the liveness of a single cell
+ */
+void s4354198_bitgrid_set(BitGrid* grid, int y, int x, bool alive) {
+    uint64_t* word = &(s4354198_bitgrid_row(grid, y)[1 + x / BITGRID_WORD_BITS]);
+    uint64_t mask = 1ULL << (x % BITGRID_WORD_BITS);
+
+    if (alive) {
+        *word |= mask;
+    } else {
+        *word &= ~mask;
+    }
+}
+
+/**
+ * Sets the liveness of a whole row from its cell ids, where any id but 0
+ * is alive
+ */
+void s4354198_bitgrid_load_row(BitGrid* grid, int y, const uint16_t* ids) {
+    s4354198_bitgrid_load_words(grid, y, ids, 0, grid->words);
+}
+
+/**
+ * Sets the liveness of words [wordStart, wordEnd) of a row from the ids 
+ * of the whole row
+ */
+void s4354198_bitgrid_load_words(BitGrid* grid, int y, const uint16_t* ids, int wordStart,
+        int wordEnd) {
+    uint64_t* words = s4354198_bitgrid_row(grid, y);
+
+    for (int k = wordStart; k < wordEnd; k++) {
+        int end = (grid->width < (k + 1) * BITGRID_WORD_BITS) ? 
+            grid->width : (k + 1) * BITGRID_WORD_BITS;
+        uint64_t word = 0;
+
+        for (int x = k * BITGRID_WORD_BITS; x < end; x++) {
+            word |= (uint64_t) (ids[x] != 0) << (x % BITGRID_WORD_BITS);
+        }
+        words[k + 1] = word;
+    }
+}
+
+/**
+ * Gets the liveness of a single cell
+ */
+bool s4354198_bitgrid_get(BitGrid* grid, int y, int x) {
+    uint64_t word = s4354198_bitgrid_row(grid, y)[1 + x / BITGRID_WORD_BITS];
+
+    return (word >> (x % BITGRID_WORD_BITS)) & 1;
+}
+
+/**
+ * Fills the guard bits from the opposite edges, so the kernels step the
+ * board as a torus without knowing about it. The bit just past the right
+ * edge may sit in the last word rather than the guard word, and is 
+ * masked off again when that word is next stepped.
+ */
+void s4354198_bitgrid_wrap(BitGrid* grid) {
+    int width = grid->width;
+    int height = grid->height;
+    int right = 1 + width / BITGRID_WORD_BITS;
+    uint64_t rightMask = 1ULL << (width % BITGRID_WORD_BITS);
+
+    for (int y = 0; y < height; y++) {
+        uint64_t* row = s4354198_bitgrid_row(grid, y);
+        uint64_t first = row[1] & 1;
+        uint64_t last = (row[1 + (width - 1) / BITGRID_WORD_BITS] >> 
+            ((width - 1) % BITGRID_WORD_BITS)) & 1;
+
+        // Only the top bit of the left guard is ever shifted in
+        row[0] = last << 63;
+        row[right] = (row[right] & ~rightMask) | (first ? rightMask : 0);
+    }
+
+    memcpy(s4354198_bitgrid_row(grid, -1), s4354198_bitgrid_row(grid, height - 1), 
+        sizeof(uint64_t) * grid->stride);
+    memcpy(s4354198_bitgrid_row(grid, height), s4354198_bitgrid_row(grid, 0), 
+        sizeof(uint64_t) * grid->stride);
+}
+
+/**
+ * Computes rows [rowStart, rowEnd) of the next generation into newGrid
+ */
+void s4354198_bitgrid_step(BitGrid* oldGrid, BitGrid* newGrid, int rowStart, int rowEnd) {
+    s4354198_bitgrid_step_words(oldGrid, newGrid, rowStart, rowEnd, 0, oldGrid->words);
+}
+
+/**
+ * Computes words [wordStart, wordEnd) of rows [rowStart, rowEnd) of the
+ * next generation into newGrid
+ */
+void s4354198_bitgrid_step_words(BitGrid* oldGrid, BitGrid* newGrid, int rowStart, 
+        int rowEnd, int wordStart, int wordEnd) {
+    int tailBits = oldGrid->width % BITGRID_WORD_BITS;
+    uint64_t tailMask = (tailBits == 0) ? ~0ULL : ((1ULL << tailBits) - 1);
+
+    for (int y = rowStart; y < rowEnd; y++) {
+        uint64_t* out = s4354198_bitgrid_row(newGrid, y);
+
+        stepRow(s4354198_bitgrid_row(oldGrid, y - 1) + wordStart, 
+            s4354198_bitgrid_row(oldGrid, y) + wordStart,
+            s4354198_bitgrid_row(oldGrid, y + 1) + wordStart, 
+            out + wordStart, wordEnd - wordStart);
+
+        // Births past the right edge must not leak into the padding
+        if (wordEnd == oldGrid->words) {
+            out[oldGrid->words] &= tailMask;
+        }
+    }
+}
+
+/**
+ * Gets the name of the kernel being used
+ */
+const char* s4354198_bitgrid_kernel_name(void) {
+    select_kernel();
+
+    return stepRowName;
+}
+
+/**
+ * Restricts the bit grids to the named kernel, so kernels can be compared on
+ * the same board. Returns false if the kernel is unknown or this CPU
+ * cannot run it.
+ */
+bool s4354198_bitgrid_use_kernel(const char* name) {
+    for (int i = 0; i < sizeof(kernelNames) / sizeof(kernelNames[0]); i++) {
+        if (strcmp(name, kernelNames[i]) == 0) {
+            widestKernel = i;
+            stepRow = NULL;
+            select_kernel();
+
+            return strcmp(stepRowName, name) == 0;
+        }
+    }
+
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "s4354198_rule.h"
+
+/* Defines */
+#define BITGRID_WORD_BITS 64
+#define BITGRID_ALIGN 64
+
+/*
+ * Liveness of a board packed 64 cells to a word. Every row has a zero
+ * guard word on either side and the grid has a zero guard row above and
+ * below, so the kernels never need to bounds check.
+ */
+typedef struct {
+    int width;
+    int height;
+    int words;
+    int stride;
+    uint64_t* cells;
+} BitGrid;
+
+/* Function prototypes */
+BitGrid* s4354198_bitgrid_create(int width, int height);
+void s4354198_bitgrid_free(BitGrid* grid);
+void s4354198_bitgrid_clear(BitGrid* grid);
+void s4354198_bitgrid_set(BitGrid* grid, int y, int x, bool alive);
+void s4354198_bitgrid_load_row(BitGrid* grid, int y, const uint16_t* ids);
+void s4354198_bitgrid_load_words(BitGrid* grid, int y, const uint16_t* ids, int wordStart,
+    int wordEnd);
+bool s4354198_bitgrid_get(BitGrid* grid, int y, int x);
+uint64_t* s4354198_bitgrid_row(BitGrid* grid, int y);
+void s4354198_bitgrid_wrap(BitGrid* grid);
+void s4354198_bitgrid_step(BitGrid* oldGrid, BitGrid* newGrid, int rowStart, int rowEnd);
+void s4354198_bitgrid_step_words(BitGrid* oldGrid, BitGrid* newGrid, int rowStart, 
+    int rowEnd, int wordStart, int wordEnd);
+void s4354198_bitgrid_set_rule(const Rule* rule);
+const char* s4354198_bitgrid_kernel_name(void);
+bool s4354198_bitgrid_use_kernel(const char* name);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s4354198_census.h"
+
+/**
+ * Creates an empty census with the given number of recording slots
+ */
+Census* s4354198_census_create(int slots) {
+    Census* census = (Census*) malloc(sizeof(Census));
+    census->capacity = CENSUS_INITIAL_CAPACITY;
+    census->counts = (int*) calloc(census->capacity, sizeof(int));
+    census->alive = (bool*) calloc(census->capacity, sizeof(bool));
+    census->dead = (int*) malloc(sizeof(int) * census->capacity);
+    census->slots = slots;
+    census->population = 0;
+    census->deltas = (CensusDelta*) malloc(sizeof(CensusDelta) * slots);
+
+    for (int i = 0; i < slots; i++) {
+        CensusDelta* delta = &(census->deltas[i]);
+        delta->deltas = (int*) calloc(census->capacity, sizeof(int));
+        delta->listed = (bool*) calloc(census->capacity, sizeof(bool));
+        delta->touched = (int*) malloc(sizeof(int) * census->capacity);
+        delta->touchedCount = 0;
+    }
+
+    return census;
+}
+
+/**
+ * Makes sure the census can count the given id. Must not be called
+ * while a generation is being computed.
+ */
+void s4354198_census_reserve(Census* census, int id) {
+    if (id < census->capacity) {
+        return;
+    }
+
+    int capacity = census->capacity;
+    while (capacity <= id) {
+        capacity *= 2;
+    }
+
+    census->counts = (int*) realloc(census->counts, sizeof(int) * capacity);
+    census->alive = (bool*) realloc(census->alive, sizeof(bool) * capacity);
+    census->dead = (int*) realloc(census->dead, sizeof(int) * capacity);
+    memset(&(census->counts[census->capacity]), 0, 
+        sizeof(int) * (capacity - census->capacity));
+    memset(&(census->alive[census->capacity]), 0, 
+        sizeof(bool) * (capacity - census->capacity));
+
+    for (int i = 0; i < census->slots; i++) {
+        CensusDelta* delta = &(census->deltas[i]);
+        delta->deltas = (int*) realloc(delta->deltas, sizeof(int) * capacity);
+        delta->listed = (bool*) realloc(delta->listed, sizeof(bool) * capacity);
+        delta->touched = (int*) realloc(delta->touched, sizeof(int) * capacity);
+        memset(&(delta->deltas[census->capacity]), 0, 
+            sizeof(int) * (capacity - census->capacity));
+        memset(&(delta->listed[census->capacity]), 0, 
+            sizeof(bool) * (capacity - census->capacity));
+    }
+
+    census->capacity = capacity;
+}
+
+/**
+ * Applies every slot's recorded changes. Returns the number of ids that
+ * have no cells left, which are listed in census->dead.
+ */
+int s4354198_census_merge(Census* census) {
+    int deadCount = 0;
+
+    for (int i = 0; i < census->slots; i++) {
+        CensusDelta* delta = &(census->deltas[i]);
+
+        for (int j = 0; j < delta->touchedCount; j++) {
+            int id = delta->touched[j];
+            census->counts[id] += delta->deltas[id];
+            census->population += delta->deltas[id];
+            delta->deltas[id] = 0;
+            delta->listed[id] = false;
+
+            if (census->counts[id] > 0) {
+                census->alive[id] = true;
+            }
+        }
+    }
+
+    // An id can be touched by several slots, so only report it once
+    for (int i = 0; i < census->slots; i++) {
+        CensusDelta* delta = &(census->deltas[i]);
+
+        for (int j = 0; j < delta->touchedCount; j++) {
+            int id = delta->touched[j];
+
+            if (census->counts[id] == 0 && census->alive[id]) {
+                census->alive[id] = false;
+                census->dead[deadCount++] = id;
+            }
+        }
+
+        delta->touchedCount = 0;
+    }
+
+    return deadCount;
+}
+
+/**
+ * Lists every id that still has cells in census->dead, returning the count
+ */
+int s4354198_census_alive(Census* census) {
+    int count = 0;
+
+    for (int id = 1; id < census->capacity; id++) {
+        if (census->alive[id]) {
+            census->dead[count++] = id;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Forgets every count, as when the board is cleared
+ */
+void s4354198_census_reset(Census* census) {
+    census->population = 0;
+    memset(census->counts, 0, sizeof(int) * census->capacity);
+    memset(census->alive, 0, sizeof(bool) * census->capacity);
+
+    for (int i = 0; i < census->slots; i++) {
+        CensusDelta* delta = &(census->deltas[i]);
+
+        for (int j = 0; j < delta->touchedCount; j++) {
+            delta->deltas[delta->touched[j]] = 0;
+            delta->listed[delta->touched[j]] = false;
+        }
+        delta->touchedCount = 0;
+    }
+}
+
+/**
+ * Moves the counts of the first count ids to the ids given by remap. Any
+ * pending changes must have been merged first.
+ */
+void s4354198_census_remap(Census* census, uint16_t* remap, int count) {
+    int* counts = (int*) calloc(census->capacity, sizeof(int));
+    bool* alive = (bool*) calloc(census->capacity, sizeof(bool));
+
+    for (int id = 1; id < count; id++) {
+        if (remap[id] != 0) {
+            counts[remap[id]] = census->counts[id];
+            alive[remap[id]] = census->alive[id];
+        }
+    }
+
+    free(census->counts);
+    free(census->alive);
+    census->counts = counts;
+    census->alive = alive;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef CENSUS_H
+#define CENSUS_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines */
+#define CENSUS_INITIAL_CAPACITY 64
+
+/*
+ * Changes to the live cell counts made by one thread during a generation.
+ * Only ids that were touched are listed, so merging is proportional to
+ * the number of ids that changed rather than the size of the board. Each
+ * id is listed at most once, so the list never outgrows the census.
+ */
+typedef struct {
+    int* deltas;
+    bool* listed;
+    int* touched;
+    int touchedCount;
+} CensusDelta;
+
+/*
+ * Live cell counts for every lifeform id
+ */
+typedef struct {
+    int capacity;
+    int* counts;
+    bool* alive;
+    int slots;
+    CensusDelta* deltas;
+    int* dead;
+    long population;
+} Census;
+
+/* Function prototypes */
+Census* s4354198_census_create(int slots);
+void s4354198_census_reserve(Census* census, int id);
+int s4354198_census_merge(Census* census);
+int s4354198_census_alive(Census* census);
+void s4354198_census_reset(Census* census);
+void s4354198_census_remap(Census* census, uint16_t* remap, int count);
+
+/**
+ * Adds a change to the live cell count of an id. Each thread must use its
+ * own slot, so no locking is needed while a generation runs.
+ */
+static inline void s4354198_census_add(Census* census, int slot, int id, int change) {
+    CensusDelta* delta = &(census->deltas[slot]);
+
+    if (id == 0) {
+        return;
+    }
+
+    // A change can go back to 0 and move again, as with a birth then a 
+    // death, so whether it is listed is kept apart from the change
+    if (!delta->listed[id]) {
+        delta->listed[id] = true;
+        delta->touched[delta->touchedCount++] = id;
+    }
+    delta->deltas[id] += change;
+}
+
+/**
+ * Records that a cell changed owner from oldId to newId
+ */
+static inline void s4354198_census_record(Census* census, int slot, int oldId, int newId) {
+    s4354198_census_add(census, slot, oldId, -1);
+    s4354198_census_add(census, slot, newId, 1);
+}
+
+#endif
\ No newline at end of file
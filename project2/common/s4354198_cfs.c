@@ -47,7 +47,12 @@ herr_t iterate_find_dir_by_name(hid_t loc, const char* name, const H5L_info_t* i
 hid_t get_file(PathInfo* pathInfo, hid_t root);
 herr_t find_file(hid_t loc, const char* name, const H5L_info_t* infoh5, void* data);
 int get_volume_next_sector(char* volumeName, hid_t root);
-void write_volume_sector(char* volumeName, char* sectorName, hid_t file, int* data);
+bool write_volume_sector(char* volumeName, char* sectorName, hid_t file, RecordedFrame* frame);
+RecordedFrame* read_volume_sector(hid_t sector);
+RecordedFrame* read_volume_tile(hid_t sector);
+void set_sector_size(hid_t sector, const char* name, int value);
+int get_sector_size(hid_t sector, const char* name);
+long get_sector_bytes(hid_t volume, int sector);
 void mark_used_volume_sector(char* volumeName, int sector, hid_t hdfFile);
 
 /**
@@ -79,23 +84,9 @@ void s4354198_createCFS(char* filename) {
         char volume[16];
         sprintf(volume, "%s%d", CFS_VOLUME, i);
 
+        // Sectors are made as frames are written, at the size each needs
         hid_t fileVolume = H5Gcreate(file, volume, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
-        // Create sectors
-        for (int j = 0; j < CFS_VOLUME_SECTORS; j++) {
-            char sector[16];
-            sprintf(sector, "%s%d", CFS_SECTOR, j);
-
-            hsize_t dims[CFS_SECTOR_RANK] = {CFS_SECTOR_WIDTH, CFS_SECTOR_HEIGHT};
-
-            hid_t space = H5Screate_simple(CFS_SECTOR_RANK, dims, NULL);
-            hid_t dataSector = H5Dcreate(fileVolume, sector, H5T_STD_I32LE, space,
-                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-
-            H5Sclose(space);
-            H5Dclose(dataSector);
-        }
-
         // Create space map
         hsize_t dimSec[2] = {CFS_VOLUME_SECTORS, 1};
         hid_t space = H5Screate_simple(2, dimSec, NULL);
@@ -116,14 +107,16 @@ void s4354198_createCFS(char* filename) {
 }
 
 /**
- * Gets the number of used sectors
+ * Gets the number of used sectors, and the bytes they take up
  */
-int s4354198_get_used_sectors() {
+int s4354198_get_used_sectors(long* bytes) {
     int used = 0;
 
     hid_t hdfFile = wait_open_cfs();
     hid_t root = H5Gopen(hdfFile, CFS_ROOT, H5P_DEFAULT);
 
+    *bytes = 0;
+
     char volumeName[20];
     for (int i = 0; i < CFS_VOLUME_COUNT; i++) {
         sprintf(volumeName, "%s%d", CFS_VOLUME, i);
@@ -141,6 +134,7 @@ int s4354198_get_used_sectors() {
         for (int i = 0; i < dimensions[0] * dimensions[1]; i++) {
             if (data[i] != 0) {
                 used++;
+                *bytes += get_sector_bytes(volume, i);
             }
         }
 
@@ -156,16 +150,60 @@ int s4354198_get_used_sectors() {
     return used;
 }
 
+/**
+ * Gets the bytes a sector of a volume takes up in the file system
+ */
+long get_sector_bytes(hid_t volume, int sector) {
+    char sectorName[20];
+    sprintf(sectorName, "%s%d", CFS_SECTOR, sector);
+
+    hid_t data = H5Dopen(volume, sectorName, H5P_DEFAULT);
+    if (data < 0) {
+        return 0;
+    }
+
+    long bytes = (long) H5Dget_storage_size(data);
+    H5Dclose(data);
+
+    return bytes;
+}
+
+/**
+ * Gets the bytes the sectors of a file take up
+ */
+long s4354198_get_file_bytes(PathInfo* pathInfo) {
+    long bytes = 0;
+
+    hid_t hdfFile = wait_open_cfs();
+    hid_t root = H5Gopen(hdfFile, CFS_ROOT, H5P_DEFAULT);
+    hid_t file = get_file(pathInfo, root);
+    hid_t volume = H5Gopen(hdfFile, pathInfo->volume, H5P_DEFAULT);
+
+    int* sectors = get_file_sectors(file);
+    int count = get_file_sector_count(sectors, CFS_VOLUME_SECTORS);
+    for (int i = 0; i < count; i++) {
+        bytes += get_sector_bytes(volume, sectors[i]);
+    }
+    free(sectors);
+
+    H5Gclose(volume);
+    H5Gclose(file);
+    H5Gclose(root);
+    H5Fclose(hdfFile);
+
+    return bytes;
+}
+
 /**
  * Reads a frame from a file, specified by name
  */
-int* s4354198_get_file_frame_from_filename(char* filename, int frame) {
+RecordedFrame* s4354198_get_file_frame_from_filename(char* filename, int frame) {
     char* msg;
     PathInfo* pathInfo = s4354198_path_info();
 
     s4354198_path(filename, &pathInfo, &msg);
 
-    int* data = s4354198_get_file_frame(pathInfo, frame);
+    RecordedFrame* data = s4354198_get_file_frame(pathInfo, frame);
 
     s4354198_path_free_info(pathInfo);
 
@@ -173,13 +211,12 @@ int* s4354198_get_file_frame_from_filename(char* filename, int frame) {
 }
 
 /**
- * Reads a frame from a file
+ * Reads a frame from a file. Each frame is one sector.
  */
-int* s4354198_get_file_frame(PathInfo* pathInfo, int frame) {
+RecordedFrame* s4354198_get_file_frame(PathInfo* pathInfo, int frame) {
     // Move to 0 indexing
     frame--;
 
-    int* data = malloc(sizeof(int) * MAX_WIDTH * MAX_HEIGHT);
     char sectorName[20];
 
     hid_t hdfFile = wait_open_cfs();
@@ -187,36 +224,23 @@ int* s4354198_get_file_frame(PathInfo* pathInfo, int frame) {
     hid_t file = get_file(pathInfo, root);
 
     // Get fv sector
-    int fvSector;
-    hid_t fvSectors = H5Dopen(file, CFS_ATTR_SECTORS, H5P_DEFAULT);
-    hid_t dataSpace = H5Dget_space(fvSectors);
-    int rank = H5Sget_simple_extent_ndims(dataSpace);
-    hsize_t dimensions[2];
-    H5Sget_simple_extent_dims(dataSpace, dimensions, NULL);
-    hsize_t offset[2] = {0, 0};
-    H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset, NULL, dimensions, NULL);
-    hid_t memSpace = H5Screate_simple(rank, dimensions, NULL);
-    H5Sselect_hyperslab(memSpace, H5S_SELECT_SET, offset, NULL, dimensions, NULL);
-    int* sectorData = (int*) malloc(sizeof(int) * dimensions[0] * dimensions[1]);
-    H5Dread(fvSectors, H5T_NATIVE_INT, memSpace, dataSpace, H5P_DEFAULT, sectorData);
-    fvSector = sectorData[frame];
-    H5Dclose(fvSectors);
-    sprintf(sectorName, "%s%d", CFS_SECTOR, fvSector);
+    int* sectors = get_file_sectors(file);
+    sprintf(sectorName, "%s%d", CFS_SECTOR, sectors[frame]);
+    free(sectors);
 
     // Get fv sector data
     hid_t volume = H5Gopen(hdfFile, pathInfo->volume, H5P_DEFAULT);
     hid_t sector = H5Dopen(volume, sectorName, H5P_DEFAULT);
-    
-    dataSpace = H5Dget_space(sector);
-    rank = H5Sget_simple_extent_ndims(dataSpace);
-    H5Sget_simple_extent_dims(dataSpace, dimensions, NULL);
-    offset[0] = 0;
-    offset[1] = 0;
-    H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset, NULL, dimensions, NULL);
-    memSpace = H5Screate_simple(rank, dimensions, NULL);
-    H5Sselect_hyperslab(memSpace, H5S_SELECT_SET, offset, NULL, dimensions, NULL);
-    H5Dread(sector, H5T_NATIVE_INT, memSpace, dataSpace, H5P_DEFAULT, data);
+    hid_t dataSpace = H5Dget_space(sector);
+    RecordedFrame* data;
 
+    if (H5Sget_simple_extent_ndims(dataSpace) == CFS_TILE_RANK) {
+        data = read_volume_tile(sector);
+    } else {
+        data = read_volume_sector(sector);
+    }
+
+    H5Sclose(dataSpace);
     H5Dclose(sector);
     H5Gclose(volume);
 
@@ -227,6 +251,63 @@ int* s4354198_get_file_frame(PathInfo* pathInfo, int frame) {
     return data;
 }
 
+/**
+ * Reads the runs of a frame from its sector
+ */
+RecordedFrame* read_volume_sector(hid_t sector) {
+    RecordedFrame* frame = (RecordedFrame*) malloc(sizeof(RecordedFrame));
+
+    hid_t dataSpace = H5Dget_space(sector);
+    hsize_t dimensions[1];
+    H5Sget_simple_extent_dims(dataSpace, dimensions, NULL);
+    H5Sclose(dataSpace);
+
+    frame->width = get_sector_size(sector, CFS_ATTR_WIDTH);
+    frame->height = get_sector_size(sector, CFS_ATTR_HEIGHT);
+    frame->runCount = (int) (dimensions[0] / 2);
+    // Never left empty, so a frame with no runs still has somewhere to point
+    frame->runs = (int*) malloc(sizeof(int) * (dimensions[0] + 1));
+    H5Dread(sector, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, frame->runs);
+
+    return frame;
+}
+
+/**
+ * Reads a sector written as a dense tile before frames were stored as 
+ * runs, turning it into runs
+ */
+RecordedFrame* read_volume_tile(hid_t sector) {
+    RecordedFrame* frame = (RecordedFrame*) malloc(sizeof(RecordedFrame));
+    int tile[CFS_SECTOR_WIDTH * CFS_SECTOR_HEIGHT];
+
+    H5Dread(sector, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, tile);
+
+    frame->width = CFS_SECTOR_WIDTH;
+    frame->height = CFS_SECTOR_HEIGHT;
+    frame->runCount = 0;
+    frame->runs = (int*) malloc(sizeof(int) * 2 * CFS_SECTOR_WIDTH * CFS_SECTOR_HEIGHT);
+
+    for (int i = 0; i < CFS_SECTOR_WIDTH * CFS_SECTOR_HEIGHT; i++) {
+        if (frame->runCount > 0 && frame->runs[2 * frame->runCount - 2] == tile[i]) {
+            frame->runs[2 * frame->runCount - 1]++;
+        } else {
+            frame->runs[2 * frame->runCount] = tile[i];
+            frame->runs[2 * frame->runCount + 1] = 1;
+            frame->runCount++;
+        }
+    }
+
+    return frame;
+}
+
+/**
+ * Frees a frame read from a file
+ */
+void s4354198_free_file_frame(RecordedFrame* frame) {
+    free(frame->runs);
+    free(frame);
+}
+
 /**
  * Gets the number of sectors of a file
  */
@@ -270,9 +351,10 @@ int s4354198_get_file_sector_count_from_filename(char* filename) {
 }
 
 /**
- * Writes a sector to a file
+ * Writes a frame to a file as a new sector. Returns false if there is no
+ * sector left for it or it could not be stored.
  */
-bool s4354198_write_sector_to_file(char* filename, int* data) {
+bool s4354198_write_frame_to_file(char* filename, RecordedFrame* frame) {
     bool success = true;
     char* path = strdup(filename);
     char sector[20];
@@ -291,8 +373,7 @@ bool s4354198_write_sector_to_file(char* filename, int* data) {
     sprintf(sector, "%s%d", CFS_SECTOR, volumeSector);
 
     // Write the sector
-    if (volumeSector >= 0) {
-        write_volume_sector(pathInfo->volume, sector, hdfFile, data);
+    if (volumeSector >= 0 && write_volume_sector(pathInfo->volume, sector, hdfFile, frame)) {
         mark_used_volume_sector(pathInfo->volume, volumeSector, hdfFile);
     } else {
         success = false;
@@ -393,25 +474,62 @@ void mark_used_volume_sector(char* volumeName, int sector, hid_t hdfFile) {
 }
 
 /**
- * Write data to a volume sector
+ * Writes a frame's runs to a volume sector, made just big enough for them
  */
-void write_volume_sector(char* volumeName, char* sectorName, hid_t file, int* data) {
+bool write_volume_sector(char* volumeName, char* sectorName, hid_t file, RecordedFrame* frame) {
     hid_t volume = H5Gopen(file, volumeName, H5P_DEFAULT);
-    hid_t sector = H5Dopen(volume, sectorName, H5P_DEFAULT);
-    
-    hid_t dataSpace = H5Dget_space(sector);
-    int rank = H5Sget_simple_extent_ndims(dataSpace);
-    hsize_t dimensions[2];
-    H5Sget_simple_extent_dims(dataSpace, dimensions, NULL);
-    hsize_t offset[2] = {0, 0};
-    H5Sselect_hyperslab(dataSpace, H5S_SELECT_SET, offset, NULL, dimensions, NULL);
-    hid_t memSpace = H5Screate_simple(rank, dimensions, NULL);
-    H5Sselect_hyperslab(memSpace, H5S_SELECT_SET, offset, NULL, dimensions, NULL);
 
-    H5Dwrite(sector, H5T_NATIVE_INT, memSpace, dataSpace, H5P_DEFAULT, data);
+    // File systems made before frames were stored as runs have every 
+    // sector already made as a tile
+    if (H5Lexists(volume, sectorName, H5P_DEFAULT) > 0) {
+        H5Ldelete(volume, sectorName, H5P_DEFAULT);
+    }
+
+    hsize_t dimensions[CFS_SECTOR_RANK] = {(hsize_t) frame->runCount * 2};
+    hid_t dataSpace = H5Screate_simple(CFS_SECTOR_RANK, dimensions, NULL);
+    hid_t sector = H5Dcreate(volume, sectorName, H5T_STD_I32LE, dataSpace,
+        H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Sclose(dataSpace);
+
+    if (sector < 0) {
+        H5Gclose(volume);
+        return false;
+    }
+
+    bool written = frame->runCount == 0 || 
+        H5Dwrite(sector, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, frame->runs) >= 0;
+    set_sector_size(sector, CFS_ATTR_WIDTH, frame->width);
+    set_sector_size(sector, CFS_ATTR_HEIGHT, frame->height);
 
     H5Dclose(sector);
     H5Gclose(volume);
+
+    return written;
+}
+
+/**
+ * Records one side of the board a sector's frame was taken from
+ */
+void set_sector_size(hid_t sector, const char* name, int value) {
+    hsize_t dims[1] = {1};
+    hid_t space = H5Screate_simple(1, dims, NULL);
+    hid_t attr = H5Acreate(sector, name, H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT);
+    H5Awrite(attr, H5T_NATIVE_INT, &value);
+    H5Sclose(space);
+    H5Aclose(attr);
+}
+
+/**
+ * Gets one side of the board a sector's frame was taken from
+ */
+int get_sector_size(hid_t sector, const char* name) {
+    int value = 0;
+
+    hid_t attr = H5Aopen(sector, name, H5P_DEFAULT);
+    H5Aread(attr, H5T_NATIVE_INT, &value);
+    H5Aclose(attr);
+
+    return value;
 }
 
 /**
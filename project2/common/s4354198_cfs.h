@@ -13,12 +13,14 @@ INode* s4354198_ls(PathInfo* pathInfo);
 bool s4354198_path(char* path, PathInfo** result, char** msg);
 void s4354198_path_free_info(PathInfo* pathInfo);
 bool s4354198_path_taken(PathInfo* pathInfo, bool* byDir);
-bool s4354198_write_sector_to_file(char* filename, int* data);
+bool s4354198_write_frame_to_file(char* filename, RecordedFrame* frame);
 int s4354198_get_file_sector_count(PathInfo* pathInfo);
 int s4354198_get_file_sector_count_from_filename(char* filename);
-int* s4354198_get_file_frame(PathInfo* pathInfo, int frame);
-int* s4354198_get_file_frame_from_filename(char* filename, int frame);
-int s4354198_get_used_sectors();
+long s4354198_get_file_bytes(PathInfo* pathInfo);
+RecordedFrame* s4354198_get_file_frame(PathInfo* pathInfo, int frame);
+RecordedFrame* s4354198_get_file_frame_from_filename(char* filename, int frame);
+void s4354198_free_file_frame(RecordedFrame* frame);
+int s4354198_get_used_sectors(long* bytes);
 PathInfo* s4354198_path_info();
 
 #endif
\ No newline at end of file
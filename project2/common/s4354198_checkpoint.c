@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "s4354198_checkpoint.h"
+
+/* Function prototypes */
+static void save_planes(FILE* file, CheckpointHeader* header, Game* game);
+static uint64_t plane_bytes(CheckpointHeader* header);
+static bool valid_ids(Checkpoint* checkpoint);
+static bool unique_tiles(Checkpoint* checkpoint);
+static int compare_tiles(const void* a, const void* b);
+
+/**
+ * Gets the cell layout an engine is checkpointed with
+ */
+CheckpointKind s4354198_checkpoint_kind(EngineType engine) {
+    switch (engine) {
+        case ENGINE_HASHLIFE:
+            return CHECKPOINT_HASHLIFE;
+        case ENGINE_SPARSE:
+            return CHECKPOINT_SPARSE;
+        default:
+            return CHECKPOINT_GRID;
+    }
+}
+
+/**
+ * Gets a name for a cell layout to show the user
+ */
+const char* s4354198_checkpoint_kind_name(CheckpointKind kind) {
+    switch (kind) {
+        case CHECKPOINT_HASHLIFE:
+            return "hashlife";
+        case CHECKPOINT_SPARSE:
+            return "sparse";
+        default:
+            return "fixed size";
+    }
+}
+
+/**
+ * Writes the current generation, the lifeform ids and the lifeforms
+ * waiting to be drawn to a file. The caller must stop the game and the
+ * drawing while this runs. Returns false with errno set if the file 
+ * could not be written.
+ */
+bool s4354198_checkpoint_save(const char* path, Game* game, ShellArgs* args) {
+    FILE* file = fopen(path, "wb");
+    CheckpointHeader header;
+    const int* ids = game->ids->toReal;
+    int idCount = game->ids->count;
+
+    if (file == NULL) {
+        return false;
+    }
+    errno = 0;
+
+    // Hashlife only knows which ids have been drawn
+    if (game->life != NULL) {
+        ids = game->life->ids;
+        idCount = game->life->idCount;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LENGTH);
+    header.version = CHECKPOINT_VERSION;
+    header.kind = s4354198_checkpoint_kind(args->engine);
+    header.width = args->width;
+    header.height = args->height;
+    memcpy(header.rule, args->rule.name, RULE_NAME_LENGTH);
+    header.generation = game->generation;
+    header.viewX = game->viewX;
+    header.viewY = game->viewY;
+    header.idCount = idCount;
+
+    // The header is written again once the counts are known
+    fwrite(&header, sizeof(header), 1, file);
+
+    for (int i = 0; i < idCount; i++) {
+        int32_t id = ids[i];
+        fwrite(&id, sizeof(id), 1, file);
+        header.lastId = (id > header.lastId) ? id : header.lastId;
+    }
+
+    for (QueueNode* node = s4354198_queue_first(game->newLifeForms); node != NULL; 
+            node = s4354198_queue_next(game->newLifeForms, node)) {
+        LifeForm* lifeForm = (LifeForm*) node;
+
+        // Patterns arriving during the save are drawn after it, not kept
+        if (lifeForm->pattern != NULL) {
+            continue;
+        }
+
+        CheckpointLifeForm saved = {
+            .id = lifeForm->id, 
+            .x = lifeForm->x, 
+            .y = lifeForm->y,
+            .lifeType = lifeForm->lifeType, 
+            .formType = lifeForm->formType
+        };
+
+        fwrite(&saved, sizeof(saved), 1, file);
+        header.lifeFormCount++;
+        header.lastId = (saved.id > header.lastId) ? saved.id : header.lastId;
+    }
+
+    while (ftell(file) % CHECKPOINT_ALIGN != 0) {
+        fputc(0, file);
+    }
+    header.planeOffset = ftell(file);
+
+    save_planes(file, &header, game);
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+
+    bool failed = ferror(file);
+    if (fclose(file) != 0 || failed) {
+        if (errno == 0) {
+            errno = EIO;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Maps a checkpoint file into memory and checks that its sections fit.
+ * Returns NULL with error set to the reason if it cannot be used.
+ */
+Checkpoint* s4354198_checkpoint_open(const char* path, const char** error) {
+    struct stat info;
+    int descriptor = open(path, O_RDONLY);
+
+    if (descriptor < 0 || fstat(descriptor, &info) != 0) {
+        *error = strerror(errno);
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+        return NULL;
+    }
+
+    size_t size = info.st_size;
+    if (size < sizeof(CheckpointHeader)) {
+        close(descriptor);
+        *error = "not a checkpoint";
+        return NULL;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED) {
+        *error = strerror(errno);
+        return NULL;
+    }
+    // Every section is read once from start to end
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    CheckpointHeader* header = (CheckpointHeader*) data;
+    uint64_t sectionsEnd = sizeof(CheckpointHeader) + 
+        (uint64_t) header->idCount * sizeof(int32_t) +
+        (uint64_t) header->lifeFormCount * sizeof(CheckpointLifeForm);
+
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LENGTH) != 0) {
+        *error = "not a checkpoint";
+    } else if (header->version != CHECKPOINT_VERSION) {
+        *error = "written by a different version";
+    } else if (header->idCount < 0 || header->lifeFormCount < 0 || 
+            header->kind > CHECKPOINT_HASHLIFE || header->planeOffset < sectionsEnd || 
+            header->planeOffset > size || plane_bytes(header) > size - header->planeOffset) {
+        *error = "the file is cut short or corrupt";
+    } else {
+        Checkpoint* checkpoint = (Checkpoint*) malloc(sizeof(Checkpoint));
+        checkpoint->data = data;
+        checkpoint->size = size;
+        checkpoint->header = header;
+        checkpoint->ids = (int32_t*) (header + 1);
+        checkpoint->lifeForms = (CheckpointLifeForm*) (checkpoint->ids + header->idCount);
+        checkpoint->planes = (char*) data + header->planeOffset;
+
+        if (!valid_ids(checkpoint)) {
+            *error = "its lifeform ids are corrupt";
+        } else if (!unique_tiles(checkpoint)) {
+            *error = "it holds a tile more than once";
+        } else {
+            return checkpoint;
+        }
+        free(checkpoint);
+    }
+
+    munmap(data, size);
+    return NULL;
+}
+
+/**
+ * Unmaps a checkpoint
+ */
+void s4354198_checkpoint_close(Checkpoint* checkpoint) {
+    munmap(checkpoint->data, checkpoint->size);
+    free(checkpoint);
+}
+
+/**
+ * Writes the cells of the current generation in the engine's layout
+ */
+static void save_planes(FILE* file, CheckpointHeader* header, Game* game) {
+    if (game->life != NULL) {
+        header->planeCount = s4354198_hashlife_save(game->life, file);
+        return;
+    }
+
+    if (game->world != NULL) {
+        SparseWorld* world = game->world;
+        CheckpointTile tile;
+
+        for (int i = 0; i < world->tileCount; i++) {
+            SparseTile* source = world->tiles[i];
+
+            if (!source->alive[world->current]) {
+                continue;
+            }
+
+            tile.tileX = source->tileX;
+            tile.tileY = source->tileY;
+            for (int y = 0; y < SPARSE_TILE_SIDE; y++) {
+                memcpy(&tile.cells[y * SPARSE_TILE_SIDE], 
+                    s4354198_grid_row(source->grids[world->current], y),
+                    sizeof(CellId) * SPARSE_TILE_SIDE);
+            }
+            fwrite(&tile, sizeof(tile), 1, file);
+            header->planeCount++;
+        }
+        return;
+    }
+
+    for (int y = 0; y < header->height; y++) {
+        fwrite(s4354198_grid_row(game->oldState, y), sizeof(CellId), header->width, file);
+    }
+}
+
+/**
+ * Gets the number of bytes of cells a header says follow it
+ */
+static uint64_t plane_bytes(CheckpointHeader* header) {
+    switch (header->kind) {
+        case CHECKPOINT_HASHLIFE:
+            return (uint64_t) header->planeCount * CHECKPOINT_NODE_WORDS * sizeof(uint32_t);
+        case CHECKPOINT_SPARSE:
+            return (uint64_t) header->planeCount * sizeof(CheckpointTile);
+        default:
+            if (header->width < 0 || header->height < 0) {
+                return UINT64_MAX;
+            }
+            return (uint64_t) header->width * header->height * sizeof(CellId);
+    }
+}
+
+/**
+ * Checks the lifeform ids are in order and every cell refers to one of
+ * them, so the grid can be loaded as it is
+ */
+static bool valid_ids(Checkpoint* checkpoint) {
+    CheckpointHeader* header = checkpoint->header;
+    CellId highest = 0;
+
+    if (header->kind == CHECKPOINT_HASHLIFE) {
+        return true;
+    }
+
+    if (header->idCount < 1 || header->idCount > IDMAP_MAX_COMPACT + 1 || 
+            checkpoint->ids[0] != 0) {
+        return false;
+    }
+    for (int i = 1; i < header->idCount; i++) {
+        if (checkpoint->ids[i] <= checkpoint->ids[i - 1]) {
+            return false;
+        }
+    }
+
+    if (header->kind == CHECKPOINT_SPARSE) {
+        CheckpointTile* tiles = (CheckpointTile*) checkpoint->planes;
+
+        for (uint32_t i = 0; i < header->planeCount; i++) {
+            for (int j = 0; j < SPARSE_TILE_SIDE * SPARSE_TILE_SIDE; j++) {
+                highest = (tiles[i].cells[j] > highest) ? tiles[i].cells[j] : highest;
+            }
+        }
+    } else {
+        CellId* cells = (CellId*) checkpoint->planes;
+        size_t count = (size_t) header->width * header->height;
+
+        for (size_t i = 0; i < count; i++) {
+            highest = (cells[i] > highest) ? cells[i] : highest;
+        }
+    }
+
+    return highest < header->idCount;
+}
+
+/**
+ * Checks a sparse universe holds each tile once, as a repeated tile would
+ * be counted into the census twice when it is loaded
+ */
+static bool unique_tiles(Checkpoint* checkpoint) {
+    CheckpointHeader* header = checkpoint->header;
+    CheckpointTile* tiles = (CheckpointTile*) checkpoint->planes;
+    bool unique = true;
+
+    if (header->kind != CHECKPOINT_SPARSE || header->planeCount < 2) {
+        return true;
+    }
+
+    int32_t (*keys)[2] = malloc(sizeof(*keys) * header->planeCount);
+    for (uint32_t i = 0; i < header->planeCount; i++) {
+        keys[i][0] = tiles[i].tileY;
+        keys[i][1] = tiles[i].tileX;
+    }
+    qsort(keys, header->planeCount, sizeof(*keys), &compare_tiles);
+
+    for (uint32_t i = 1; i < header->planeCount && unique; i++) {
+        unique = (compare_tiles(keys[i - 1], keys[i]) != 0);
+    }
+
+    free(keys);
+    return unique;
+}
+
+/**
+ * Compare function for sorting tile positions by row then column
+ */
+static int compare_tiles(const void* a, const void* b) {
+    const int32_t* first = (const int32_t*) a;
+    const int32_t* second = (const int32_t*) b;
+
+    if (first[0] != second[0]) {
+        return (first[0] > second[0]) - (first[0] < second[0]);
+    }
+    return (first[1] > second[1]) - (first[1] < second[1]);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "s4354198_structs.h"
+
+/* Defines */
+#define CHECKPOINT_MAGIC "CAGSTATE"
+#define CHECKPOINT_MAGIC_LENGTH 8
+#define CHECKPOINT_VERSION 1
+// Cells start on a cache line so they can be copied straight out of the mapping
+#define CHECKPOINT_ALIGN 64
+#define CHECKPOINT_NODE_WORDS 4
+
+/* How the cells of a checkpoint are laid out, which depends on the engine */
+typedef enum {
+    CHECKPOINT_GRID,
+    CHECKPOINT_SPARSE,
+    CHECKPOINT_HASHLIFE
+} CheckpointKind;
+
+/*
+ * The start of a checkpoint file. It is followed by idCount lifeform 
+ * ids, lifeFormCount pending lifeforms and then, at planeOffset, the 
+ * cells. A grid is height rows of width compact ids, a sparse universe 
+ * is planeCount tiles and hashlife is planeCount nodes as written by 
+ * s4354198_hashlife_save. Numbers are in the byte order of the machine 
+ * that wrote them.
+ */
+typedef struct {
+    char magic[CHECKPOINT_MAGIC_LENGTH];
+    uint32_t version;
+    uint32_t kind;
+    int32_t width;
+    int32_t height;
+    char rule[RULE_NAME_LENGTH];
+    uint64_t generation;
+    int32_t viewX;
+    int32_t viewY;
+    int32_t lastId;
+    int32_t idCount;
+    int32_t lifeFormCount;
+    uint32_t planeCount;
+    uint64_t planeOffset;
+} CheckpointHeader;
+
+/*
+ * A lifeform that was waiting to be drawn
+ */
+typedef struct {
+    int32_t id;
+    int32_t x;
+    int32_t y;
+    int32_t lifeType;
+    int32_t formType;
+} CheckpointLifeForm;
+
+/*
+ * A tile of a sparse universe and its current generation
+ */
+typedef struct {
+    int32_t tileX;
+    int32_t tileY;
+    CellId cells[SPARSE_TILE_SIDE * SPARSE_TILE_SIDE];
+} CheckpointTile;
+
+/*
+ * A checkpoint file mapped into memory, with its sections found
+ */
+typedef struct {
+    void* data;
+    size_t size;
+    CheckpointHeader* header;
+    int32_t* ids;
+    CheckpointLifeForm* lifeForms;
+    void* planes;
+} Checkpoint;
+
+/* Function prototypes */
+CheckpointKind s4354198_checkpoint_kind(EngineType engine);
+const char* s4354198_checkpoint_kind_name(CheckpointKind kind);
+bool s4354198_checkpoint_save(const char* path, Game* game, ShellArgs* args);
+Checkpoint* s4354198_checkpoint_open(const char* path, const char** error);
+void s4354198_checkpoint_close(Checkpoint* checkpoint);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s4354198_cycle.h"
+
+/* Function prototypes */
+static void drop_frames(Cycle* cycle);
+
+/**
+ * Creates a detector with no history
+ */
+Cycle* s4354198_cycle_create(void) {
+    Cycle* cycle = (Cycle*) malloc(sizeof(Cycle));
+    cycle->idleAllowed = false;
+    cycle->framesCached = 0;
+    cycle->ticks = 0;
+    s4354198_cycle_reset(cycle);
+
+    return cycle;
+}
+
+/**
+ * Forgets the history, as when the board is changed from outside
+ */
+void s4354198_cycle_reset(Cycle* cycle) {
+    drop_frames(cycle);
+    cycle->count = 0;
+    cycle->next = 0;
+    cycle->computedTick = cycle->ticks;
+    cycle->startTick = cycle->ticks;
+    cycle->startGeneration = 0;
+    cycle->period = 0;
+    cycle->length = 0;
+    cycle->confirmed = 0;
+    cycle->reported = false;
+}
+
+/**
+ * Records the signature of a newly computed generation, looking for the 
+ * most recent tick with the same signature
+ */
+void s4354198_cycle_observe(Cycle* cycle, uint64_t signature, unsigned long generation) {
+    int length = 0;
+
+    cycle->ticks++;
+    cycle->computedTick = cycle->ticks;
+
+    // Newest first, so the shortest cycle wins
+    for (int i = 1; i <= cycle->count; i++) {
+        int slot = (cycle->next - i + CYCLE_HISTORY) % CYCLE_HISTORY;
+
+        if (cycle->signatures[slot] == signature) {
+            length = i;
+            break;
+        }
+    }
+
+    if (length == 0 || length != cycle->length) {
+        // A new candidate, whose frames are cached from this tick on
+        drop_frames(cycle);
+        cycle->length = length;
+        cycle->confirmed = 0;
+        cycle->reported = false;
+        cycle->startTick = cycle->ticks;
+        cycle->period = 0;
+        if (length != 0) {
+            int slot = (cycle->next - length + CYCLE_HISTORY) % CYCLE_HISTORY;
+            cycle->period = generation - cycle->generations[slot];
+            cycle->startGeneration = cycle->generations[slot];
+        }
+    }
+
+    if (length != 0) {
+        cycle->confirmed++;
+    }
+
+    cycle->signatures[cycle->next] = signature;
+    cycle->generations[cycle->next] = generation;
+    cycle->next = (cycle->next + 1) % CYCLE_HISTORY;
+    if (cycle->count < CYCLE_HISTORY) {
+        cycle->count++;
+    }
+}
+
+/**
+ * Checks if the board has repeated for a whole cycle
+ */
+bool s4354198_cycle_settled(Cycle* cycle) {
+    return cycle->length != 0 && cycle->confirmed >= cycle->length;
+}
+
+/**
+ * Checks if the whole cycle is cached and the engine may replay it
+ */
+bool s4354198_cycle_can_idle(Cycle* cycle) {
+    return cycle->idleAllowed && s4354198_cycle_settled(cycle) && 
+        cycle->framesCached == cycle->length;
+}
+
+/**
+ * Keeps the frame of a tick while a candidate cycle is being confirmed. 
+ * Frames are written after their tick, so they may arrive late, but must 
+ * arrive for every tick in order, otherwise the cycle is never cached.
+ */
+void s4354198_cycle_cache_frame(Cycle* cycle, const char* frame, unsigned long tick) {
+    if (cycle->length == 0 || cycle->framesCached == cycle->length ||
+            tick - cycle->startTick != (unsigned long) cycle->framesCached) {
+        return;
+    }
+
+    size_t bytes = strlen(frame) + 1;
+    if (cycle->frameBytes + bytes > CYCLE_CACHE_BYTES) {
+        return;
+    }
+
+    cycle->frames[cycle->framesCached] = (char*) malloc(bytes);
+    memcpy(cycle->frames[cycle->framesCached], frame, bytes);
+    cycle->frameBytes += bytes;
+    cycle->framesCached++;
+}
+
+/**
+ * Gets the cached frame of the current tick
+ */
+const char* s4354198_cycle_frame(Cycle* cycle) {
+    return cycle->frames[(cycle->ticks - cycle->startTick) % cycle->length];
+}
+
+/**
+ * Moves on a tick without computing anything
+ */
+void s4354198_cycle_idle_tick(Cycle* cycle) {
+    cycle->ticks++;
+}
+
+/**
+ * Gets the number of generations the engine must compute to get from 
+ * the state it holds to the replayed tick
+ */
+int s4354198_cycle_behind(Cycle* cycle) {
+    if (cycle->length == 0) {
+        return 0;
+    }
+
+    return (cycle->ticks - cycle->computedTick) % cycle->length;
+}
+
+/**
+ * Frees any cached frames
+ */
+static void drop_frames(Cycle* cycle) {
+    for (int i = 0; i < cycle->framesCached; i++) {
+        free(cycle->frames[i]);
+    }
+    cycle->framesCached = 0;
+    cycle->frameBytes = 0;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef CYCLE_H
+#define CYCLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Defines */
+// Longest cycle that can be spotted, in ticks
+#define CYCLE_HISTORY 256
+// Most frame data kept for replaying a cycle
+#define CYCLE_CACHE_BYTES (64 * 1024 * 1024)
+
+/*
+ * Signatures of the last few ticks, used to spot a board that has died
+ * out, stopped changing or started repeating. A candidate cycle has to
+ * repeat all the way through before it is settled, and its frames are
+ * cached along the way so the engine can replay them rather than keep 
+ * computing. Ticks count both computed and replayed steps.
+ */
+typedef struct {
+    uint64_t signatures[CYCLE_HISTORY];
+    unsigned long generations[CYCLE_HISTORY];
+    int count;
+    int next;
+    unsigned long ticks;
+    unsigned long computedTick;
+    unsigned long startTick;
+    unsigned long startGeneration;
+    unsigned long period;
+    int length;
+    int confirmed;
+    bool reported;
+    bool idleAllowed;
+    char* frames[CYCLE_HISTORY];
+    int framesCached;
+    size_t frameBytes;
+} Cycle;
+
+/* Function prototypes */
+Cycle* s4354198_cycle_create(void);
+void s4354198_cycle_reset(Cycle* cycle);
+void s4354198_cycle_observe(Cycle* cycle, uint64_t signature, unsigned long generation);
+bool s4354198_cycle_settled(Cycle* cycle);
+bool s4354198_cycle_can_idle(Cycle* cycle);
+void s4354198_cycle_cache_frame(Cycle* cycle, const char* frame, unsigned long tick);
+const char* s4354198_cycle_frame(Cycle* cycle);
+void s4354198_cycle_idle_tick(Cycle* cycle);
+int s4354198_cycle_behind(Cycle* cycle);
+
+/**
+ * Folds a value into a running signature
+ */
+static inline uint64_t s4354198_cycle_mix(uint64_t signature, uint64_t value) {
+    signature = (signature ^ value) * 0xff51afd7ed558ccdULL;
+    return signature ^ (signature >> 32);
+}
+
+/**
+ * Folds a run of 16 bit cells into a running signature, four at a time
+ */
+static inline uint64_t s4354198_cycle_mix_cells(uint64_t signature, 
+        const uint16_t* cells, int count) {
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        uint64_t word;
+        __builtin_memcpy(&word, cells + i, sizeof(word));
+        signature = s4354198_cycle_mix(signature, word);
+    }
+    for (; i < count; i++) {
+        signature = s4354198_cycle_mix(signature, cells[i]);
+    }
+
+    return signature;
+}
+
+#endif
\ No newline at end of file
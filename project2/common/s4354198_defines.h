@@ -5,9 +5,33 @@
 #define MAX_WIDTH 20
 #define MIN_HEIGHT 10
 #define MAX_HEIGHT 20
+#define LARGE_MAX_WIDTH 16384
+#define LARGE_MAX_HEIGHT 16384
 #define MIN_REFRESH 200
 #define MAX_REFRESH 2000
 
+#define ENGINE_NAME_DIRECT "direct"
+#define ENGINE_NAME_BITS "bits"
+#define ENGINE_NAME_HASHLIFE "hashlife"
+#define ENGINE_NAME_SPARSE "sparse"
+#define MAX_STEP_LOG 40
+// Generations with fewer cells to compute than this skip the worker pool
+#define INLINE_CELL_LIMIT (32 * 1024)
+// Generations computed as one wavefront, the same as the keyframe gap so a 
+// fast forward leaves no bigger gaps in the history
+#define WAVEFRONT_GENERATIONS 64
+// Number of polls while waiting for a neighbouring band before yielding
+#define WAVEFRONT_SPINS 4000
+// Deepest temporal block, no deeper than a tile is high so that changes 
+// can only reach the tiles next to them within one block
+#define TEMPORAL_MAX_DEPTH 16
+// Most processes a board can be split between
+#define SHARD_MAX 16
+// Random soups for benchmarks, as a percentage of live cells
+#define BENCH_DEFAULT_DENSITY 30
+#define BENCH_DEFAULT_SEED 1
+#define BENCH_SOUP_ID 1
+
 #define DISPLAY_EXECUTABLE "./display"
 #define CAG_EXECUTABLE "./cag"
 #define CP_EXECUTABLE "./player"
@@ -46,6 +70,15 @@
 #define CMD_HALP "halp"
 #define CMD_STOP_OUTPUT "stop_output"
 #define CMD_START_OUTPUT "start_output"
+#define CMD_STATS "stats"
+#define CMD_VIEW "view"
+#define CMD_RULE "rule"
+#define CMD_IDLE "idle"
+#define CMD_FF "ff"
+#define CMD_REWIND "rewind"
+#define CMD_CHECKPOINT "checkpoint"
+#define CMD_RESTORE "restore"
+#define CMD_IMPORT "import"
 
 #define FORM_ALIVE "alive"
 #define FORM_DEAD "dead"
@@ -87,10 +120,36 @@
 #define FIFO_CP_DISPLAY_PERMS 0666
 
 #define COMMS_NEW "new"
+#define COMMS_NEWBATCH "newbatch"
+#define COMMS_PATTERN "pattern"
 #define COMMS_STOP "stop"
 #define COMMS_START "start"
 #define COMMS_CLEAR "clear"
 #define COMMS_DEAD "dead"
+#define COMMS_STATS "stats"
+#define COMMS_VIEW "view"
+#define COMMS_RULE "rule"
+#define COMMS_IDLE "idle"
+#define COMMS_FF "ff"
+#define COMMS_REWIND "rewind"
+#define COMMS_CHECKPOINT "checkpoint"
+#define COMMS_RESTORE "restore"
+#define COMMS_LAST_ID "lastid"
+#define COMMS_ON "on"
+#define COMMS_OFF "off"
+
+// Commands, replies and frames for any universe but the default one start
+// with this and the universe's name, like "@load7 ff 100"
+#define UNIVERSE_TAG '@'
+#define UNIVERSE_DEFAULT "main"
+#define UNIVERSE_NAME_LENGTH 31
+// Most universes one cag hosts, each made the first time it is named
+#define UNIVERSE_MAX 1024
+
+// Lifeforms in a newbatch message are separated by this
+#define NEWBATCH_SEPARATOR ","
+// Most lifeforms the shell holds back before sending a newbatch
+#define NEWBATCH_MAX 256
 
 #define STATE_DEAD 0
 
@@ -103,6 +162,7 @@
 #define BACKSPACE "\b \b"
 
 #define CELL_SIDE 20
+#define DISPLAY_MAX_SIDE 1024
 
 #define DEFAULT_DIR "/"
 #define ROOT_DIR "/"
@@ -125,12 +185,17 @@
 #define CFS_ATTR_INODES "FileINodes"
 #define CFS_ATTR_SECTORS "Sectors"
 #define CFS_ATTR_SPACE_MAP "SpaceMap"
+#define CFS_ATTR_WIDTH "Width"
+#define CFS_ATTR_HEIGHT "Height"
 #define CFS_OWNER "Joseph Garrone (s4354198)"
 #define CFS_NO_DATA "---"
 #define CFS_DEFAULT_MODE "rw-"
 #define CFS_VOLUME_COUNT 4
 #define CFS_VOLUME_SECTORS 600
-#define CFS_SECTOR_RANK 2
+// A sector holds one frame as runs of an id then a count, sized when written
+#define CFS_SECTOR_RANK 1
+// Sectors from before were made up front as a dense tile of this size
+#define CFS_TILE_RANK 2
 #define CFS_SECTOR_WIDTH 20
 #define CFS_SECTOR_HEIGHT 20
 #define CFS_MAX_FILES 1024
@@ -0,0 +1,130 @@
+#include <stdlib.h>
+
+#include "s4354198_deque.h"
+
+/**
+ * Creates an empty deque with room for a number of tiles, or NULL if
+ * there is not the memory for it
+ */
+Deque* s4354198_deque_create(int capacity) {
+    Deque* deque;
+
+    if (posix_memalign((void**) &deque, DEQUE_ALIGN, sizeof(Deque)) != 0) {
+        return NULL;
+    }
+
+    deque->top = 0;
+    deque->bottom = 0;
+    deque->tiles = NULL;
+    deque->capacity = 0;
+
+    if (!s4354198_deque_reserve(deque, capacity)) {
+        free(deque);
+        return NULL;
+    }
+
+    return deque;
+}
+
+/**
+ * Frees a deque
+ */
+void s4354198_deque_free(Deque* deque) {
+    if (deque == NULL) {
+        return;
+    }
+
+    free(deque->tiles);
+    free(deque);
+}
+
+/**
+ * Makes room for at least a number of tiles. Only safe while no other
+ * thread is using the deque. Returns false if there is not the memory.
+ */
+bool s4354198_deque_reserve(Deque* deque, int capacity) {
+    if (capacity <= deque->capacity) {
+        return true;
+    }
+
+    int* tiles = (int*) realloc(deque->tiles, sizeof(int) * capacity);
+    if (tiles == NULL) {
+        return false;
+    }
+
+    deque->tiles = tiles;
+    deque->capacity = capacity;
+
+    return true;
+}
+
+/**
+ * Empties the deque, ready for the next lot of tiles
+ */
+void s4354198_deque_clear(Deque* deque) {
+    deque->top = 0;
+    deque->bottom = 0;
+}
+
+/**
+ * Adds a tile at the bottom. Only the owner may push, and only before 
+ * the deque is shared.
+ */
+void s4354198_deque_push(Deque* deque, int tile) {
+    deque->tiles[deque->bottom] = tile;
+    deque->bottom++;
+}
+
+/**
+ * Takes the tile at the bottom, or DEQUE_EMPTY if there are none left.
+ * Only the owner may pop.
+ */
+int s4354198_deque_pop(Deque* deque) {
+    long bottom = __atomic_load_n(&(deque->bottom), __ATOMIC_RELAXED) - 1;
+
+    // Claim the bottom tile before looking at what the thieves have taken
+    __atomic_store_n(&(deque->bottom), bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&(deque->top), __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        __atomic_store_n(&(deque->bottom), bottom + 1, __ATOMIC_RELAXED);
+        return DEQUE_EMPTY;
+    }
+
+    int tile = deque->tiles[bottom];
+
+    // The last tile goes to whoever moves the top past it first
+    if (top == bottom) {
+        if (!__atomic_compare_exchange_n(&(deque->top), &top, top + 1, false, 
+                __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            tile = DEQUE_EMPTY;
+        }
+        __atomic_store_n(&(deque->bottom), bottom + 1, __ATOMIC_RELAXED);
+    }
+
+    return tile;
+}
+
+/**
+ * Takes the tile at the top for another thread. Returns DEQUE_EMPTY if 
+ * there are none left, or DEQUE_ABORT if another thread took it first.
+ */
+int s4354198_deque_steal(Deque* deque) {
+    long top = __atomic_load_n(&(deque->top), __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&(deque->bottom), __ATOMIC_ACQUIRE);
+
+    if (top >= bottom) {
+        return DEQUE_EMPTY;
+    }
+
+    int tile = deque->tiles[top];
+
+    if (!__atomic_compare_exchange_n(&(deque->top), &top, top + 1, false, 
+            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return DEQUE_ABORT;
+    }
+
+    return tile;
+}
\ No newline at end of file
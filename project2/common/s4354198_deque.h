@@ -0,0 +1,35 @@
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include <stdbool.h>
+
+/* Defines */
+#define DEQUE_ALIGN 64
+// Returned when there was nothing to take
+#define DEQUE_EMPTY -1
+// Returned by a steal that lost a race for the last tile, and may be retried
+#define DEQUE_ABORT -2
+
+/*
+ * Work stealing deque of tile indices. Its owner pushes and pops at the 
+ * bottom, and any other thread can steal from the top, so the owner and 
+ * thieves only contend over the last tile. Everything is pushed before the
+ * work is handed out, so the deque never has to grow while it is shared.
+ */
+typedef struct {
+    long top __attribute__((aligned(DEQUE_ALIGN)));
+    long bottom __attribute__((aligned(DEQUE_ALIGN)));
+    int* tiles __attribute__((aligned(DEQUE_ALIGN)));
+    int capacity;
+} Deque;
+
+/* Function prototypes */
+Deque* s4354198_deque_create(int capacity);
+void s4354198_deque_free(Deque* deque);
+bool s4354198_deque_reserve(Deque* deque, int capacity);
+void s4354198_deque_clear(Deque* deque);
+void s4354198_deque_push(Deque* deque, int tile);
+int s4354198_deque_pop(Deque* deque);
+int s4354198_deque_steal(Deque* deque);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "s4354198_frame.h"
+#include "s4354198_defines.h"
+
+/* Function prototypes */
+static void flush_run(FrameWriter* writer);
+
+/**
+ * Creates an empty frame writer
+ */
+FrameWriter* s4354198_frame_writer_create(void) {
+    FrameWriter* writer = (FrameWriter*) malloc(sizeof(FrameWriter));
+    writer->capacity = BUFFER_SIZE;
+    writer->buffer = (char*) malloc(sizeof(char) * writer->capacity);
+    s4354198_frame_writer_reset(writer);
+
+    return writer;
+}
+
+/**
+ * Frees a frame writer
+ */
+void s4354198_frame_writer_free(FrameWriter* writer) {
+    free(writer->buffer);
+    free(writer);
+}
+
+/**
+ * Empties the writer ready for the next frame, keeping its buffer
+ */
+void s4354198_frame_writer_reset(FrameWriter* writer) {
+    writer->length = 0;
+    writer->buffer[0] = '\0';
+    writer->runId = 0;
+    writer->runLength = 0;
+}
+
+/**
+ * Appends count cells of the given id to the frame
+ */
+void s4354198_frame_writer_push(FrameWriter* writer, int id, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    if (writer->runLength > 0 && id != writer->runId) {
+        flush_run(writer);
+    }
+
+    writer->runId = id;
+    writer->runLength += count;
+}
+
+/**
+ * Writes out any pending run and gets the finished frame, which stays
+ * owned by the writer
+ */
+char* s4354198_frame_writer_finish(FrameWriter* writer) {
+    flush_run(writer);
+
+    return writer->buffer;
+}
+
+/**
+ * Writes the pending run to the buffer
+ */
+static void flush_run(FrameWriter* writer) {
+    // Two ints, a separator, a run marker and a NUL
+    size_t worst = 2 * 11 + 3;
+
+    if (writer->runLength == 0) {
+        return;
+    }
+
+    if (writer->length + worst > writer->capacity) {
+        while (writer->length + worst > writer->capacity) {
+            writer->capacity *= 2;
+        }
+        writer->buffer = (char*) realloc(writer->buffer, writer->capacity);
+    }
+
+    char* end = &(writer->buffer[writer->length]);
+    if (writer->length > 0) {
+        *end++ = FRAME_SEPARATOR;
+    }
+
+    if (writer->runLength == 1) {
+        end += sprintf(end, "%d", writer->runId);
+    } else {
+        end += sprintf(end, "%d%c%d", writer->runId, FRAME_RUN, writer->runLength);
+    }
+
+    writer->length = end - writer->buffer;
+    writer->runLength = 0;
+}
+
+/**
+ * Reads the next run from a frame line, moving the cursor past it.
+ * Plain ids are runs of one. Returns false at the end of the line.
+ */
+bool s4354198_frame_next(char** cursor, int* id, int* count) {
+    char* input = *cursor;
+    char* endToken;
+
+    if (input == NULL || *input == '\0') {
+        return false;
+    }
+
+    *id = strtol(input, &endToken, 10);
+    *count = 1;
+
+    if (endToken == input) {
+        // Not a number, so give up on the rest of the line
+        *cursor = input + strlen(input);
+        return false;
+    }
+
+    if (*endToken == FRAME_RUN) {
+        *count = strtol(endToken + 1, &endToken, 10);
+    }
+
+    if (*endToken == FRAME_SEPARATOR) {
+        endToken++;
+    }
+
+    *cursor = endToken;
+
+    return true;
+}
\ No newline at end of file
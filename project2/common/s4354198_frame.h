@@ -0,0 +1,33 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Defines */
+// Separates an id from its repeat count, as in "0*400"
+#define FRAME_RUN '*'
+#define FRAME_SEPARATOR ','
+
+/*
+ * Builds a frame line of comma separated cell ids in row major order.
+ * Runs of the same id are written as "id*count" so that large, mostly
+ * empty boards stay small on the wire.
+ */
+typedef struct {
+    char* buffer;
+    size_t length;
+    size_t capacity;
+    int runId;
+    int runLength;
+} FrameWriter;
+
+/* Function prototypes */
+FrameWriter* s4354198_frame_writer_create(void);
+void s4354198_frame_writer_free(FrameWriter* writer);
+void s4354198_frame_writer_reset(FrameWriter* writer);
+void s4354198_frame_writer_push(FrameWriter* writer, int id, int count);
+char* s4354198_frame_writer_finish(FrameWriter* writer);
+bool s4354198_frame_next(char** cursor, int* id, int* count);
+
+#endif
\ No newline at end of file
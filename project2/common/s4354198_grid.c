@@ -0,0 +1,385 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s4354198_grid.h"
+
+/* Vector types used by the wide kernels */
+typedef uint16_t Cells8 __attribute__((vector_size(16)));
+typedef uint16_t Cells16 __attribute__((vector_size(32)));
+
+/* Signature shared by all the row kernels */
+typedef void (*StepRow)(const CellId* above, const CellId* current,
+    const CellId* below, CellId* out, int width);
+
+/* Function prototypes */
+static void select_kernel(void);
+static void step_row_scalar(const CellId* above, const CellId* current,
+    const CellId* below, CellId* out, int width);
+static void step_row_rule_scalar(const CellId* above, const CellId* current,
+    const CellId* below, CellId* out, int width);
+
+/* Globals */
+// Row kernel picked for this CPU and rule
+static StepRow stepRow = NULL;
+// Name of the picked kernel
+static const char* stepRowName = "scalar";
+// Every kernel from narrowest to widest
+static const char* kernelNames[] = {"scalar", "sse2", "avx2"};
+// Index into kernelNames of the widest kernel that may be picked
+static int widestKernel = 2;
+// Rule used by the rule kernels
+static Rule rule;
+// Whether the rule is B3/S23 and can use the Conway kernels
+static bool conway = true;
+// Per neighbour count masks of the rule, all ones where a cell lives
+static CellId birthMasks[RULE_MAX_NEIGHBOURS + 1];
+static CellId surviveMasks[RULE_MAX_NEIGHBOURS + 1];
+
+/*
+ * Defines a row kernel that counts the live neighbours and finds the
+ * highest neighbouring id of LANES cells at once using vector type T.
+ * Both come out of the same eight loads. Cells are born with three
+ * neighbours, survive with two or three, and take the highest id.
+ */
+#define DEFINE_STEP_ROW(name, T, LANES, attributes) \
+attributes static void name(const CellId* above, const CellId* current, \
+        const CellId* below, CellId* out, int width) { \
+    const CellId* sources[8] = { \
+        above - 1, above, above + 1, current - 1, \
+        current + 1, below - 1, below, below + 1 \
+    }; \
+    int i = 0; \
+    for (; i + LANES <= width; i += LANES) { \
+        T count = {0}; \
+        T highest = {0}; \
+        T self; \
+        memcpy(&self, current + i, sizeof(T)); \
+        for (int k = 0; k < 8; k++) { \
+            T neighbour; \
+            memcpy(&neighbour, sources[k] + i, sizeof(T)); \
+            count -= (T) (neighbour != 0); \
+            T greater = (T) (neighbour > highest); \
+            highest = (neighbour & greater) | (highest & ~greater); \
+        } \
+        T lives = (T) (count == 3) | ((T) (self != 0) & (T) (count == 2)); \
+        T result = highest & lives; \
+        memcpy(out + i, &result, sizeof(T)); \
+    } \
+    if (i < width) { \
+        step_row_scalar(above + i, current + i, below + i, out + i, width - i); \
+    } \
+}
+
+/*
+ * Defines a row kernel like DEFINE_STEP_ROW for any rule. The count picks
+ * a birth or survive mask for each lane, so every rule takes the same 
+ * branch free path. A survivor with no neighbours keeps its own id.
+ */
+#define DEFINE_STEP_ROW_RULE(name, T, LANES, attributes) \
+attributes static void name(const CellId* above, const CellId* current, \
+        const CellId* below, CellId* out, int width) { \
+    const CellId* sources[8] = { \
+        above - 1, above, above + 1, current - 1, \
+        current + 1, below - 1, below, below + 1 \
+    }; \
+    int i = 0; \
+    for (; i + LANES <= width; i += LANES) { \
+        T count = {0}; \
+        T highest = {0}; \
+        T self; \
+        memcpy(&self, current + i, sizeof(T)); \
+        for (int k = 0; k < 8; k++) { \
+            T neighbour; \
+            memcpy(&neighbour, sources[k] + i, sizeof(T)); \
+            count -= (T) (neighbour != 0); \
+            T greater = (T) (neighbour > highest); \
+            highest = (neighbour & greater) | (highest & ~greater); \
+        } \
+        T alive = (T) (self != 0); \
+        T lives = {0}; \
+        for (int n = 0; n <= RULE_MAX_NEIGHBOURS; n++) { \
+            T masks = (alive & surviveMasks[n]) | (~alive & birthMasks[n]); \
+            lives |= (T) (count == (CellId) n) & masks; \
+        } \
+        T result = lives & (highest | (self & (T) (highest == 0))); \
+        memcpy(out + i, &result, sizeof(T)); \
+    } \
+    if (i < width) { \
+        step_row_rule_scalar(above + i, current + i, below + i, out + i, width - i); \
+    } \
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+DEFINE_STEP_ROW(step_row_sse2, Cells8, 8, __attribute__((target("sse2"))))
+DEFINE_STEP_ROW(step_row_avx2, Cells16, 16, __attribute__((target("avx2"))))
+DEFINE_STEP_ROW_RULE(step_row_rule_sse2, Cells8, 8, __attribute__((target("sse2"))))
+DEFINE_STEP_ROW_RULE(step_row_rule_avx2, Cells16, 16, __attribute__((target("avx2"))))
+#endif
+
+/**
+ * Steps a row one cell at a time
+ */
+static void step_row_scalar(const CellId* above, const CellId* current,
+        const CellId* below, CellId* out, int width) {
+    for (int i = 0; i < width; i++) {
+        int neighbours = (above[i - 1] != 0) + (above[i] != 0) + (above[i + 1] != 0) +
+            (current[i - 1] != 0) + (current[i + 1] != 0) +
+            (below[i - 1] != 0) + (below[i] != 0) + (below[i + 1] != 0);
+
+        CellId highest = above[i - 1];
+        highest = above[i] > highest ? above[i] : highest;
+        highest = above[i + 1] > highest ? above[i + 1] : highest;
+        highest = current[i - 1] > highest ? current[i - 1] : highest;
+        highest = current[i + 1] > highest ? current[i + 1] : highest;
+        highest = below[i - 1] > highest ? below[i - 1] : highest;
+        highest = below[i] > highest ? below[i] : highest;
+        highest = below[i + 1] > highest ? below[i + 1] : highest;
+
+        // Born with three, survive and take with two or three
+        int lives = (neighbours == 3) | ((current[i] != 0) & (neighbours == 2));
+        out[i] = lives ? highest : 0;
+    }
+}
+
+/**
+ * Steps a row one cell at a time under any rule
+ */
+static void step_row_rule_scalar(const CellId* above, const CellId* current,
+        const CellId* below, CellId* out, int width) {
+    for (int i = 0; i < width; i++) {
+        int neighbours = (above[i - 1] != 0) + (above[i] != 0) + (above[i + 1] != 0) +
+            (current[i - 1] != 0) + (current[i + 1] != 0) +
+            (below[i - 1] != 0) + (below[i] != 0) + (below[i + 1] != 0);
+
+        CellId highest = above[i - 1];
+        highest = above[i] > highest ? above[i] : highest;
+        highest = above[i + 1] > highest ? above[i + 1] : highest;
+        highest = current[i - 1] > highest ? current[i - 1] : highest;
+        highest = current[i + 1] > highest ? current[i + 1] : highest;
+        highest = below[i - 1] > highest ? below[i - 1] : highest;
+        highest = below[i] > highest ? below[i] : highest;
+        highest = below[i + 1] > highest ? below[i + 1] : highest;
+
+        int lives = s4354198_rule_lives(&rule, current[i] != 0, neighbours);
+        out[i] = lives ? (highest != 0 ? highest : current[i]) : 0;
+    }
+}
+
+/**
+ * Picks the widest row kernel the CPU supports for the current rule
+ */
+static void select_kernel(void) {
+    if (stepRow != NULL) {
+        return;
+    }
+
+    stepRow = conway ? &step_row_scalar : &step_row_rule_scalar;
+    stepRowName = "scalar";
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (widestKernel >= 2 && __builtin_cpu_supports("avx2")) {
+        stepRow = conway ? &step_row_avx2 : &step_row_rule_avx2;
+        stepRowName = "avx2";
+    } else if (widestKernel >= 1 && __builtin_cpu_supports("sse2")) {
+        stepRow = conway ? &step_row_sse2 : &step_row_rule_sse2;
+        stepRowName = "sse2";
+    }
+#endif
+}
+
+/**
+ * Sets the rule every grid is stepped with. Must not be called while a
+ * grid is being stepped.
+ */
+void s4354198_grid_set_rule(const Rule* newRule) {
+    rule = *newRule;
+    conway = s4354198_rule_is_conway(newRule);
+
+    for (int n = 0; n <= RULE_MAX_NEIGHBOURS; n++) {
+        birthMasks[n] = rule.table[0][n] ? (CellId) ~0 : 0;
+        surviveMasks[n] = rule.table[1][n] ? (CellId) ~0 : 0;
+    }
+
+    stepRow = NULL;
+    select_kernel();
+}
+
+/**
+ * Creates an empty grid of the given size
+ */
+Grid* s4354198_grid_create(int width, int height) {
+    select_kernel();
+
+    Grid* grid = (Grid*) malloc(sizeof(Grid));
+    grid->width = width;
+    grid->height = height;
+    // A line of padding holds the left ghost, the rest is rounded up
+    grid->stride = GRID_PAD + ((width + 1 + GRID_PAD - 1) / GRID_PAD) * GRID_PAD;
+
+    size_t bytes = sizeof(CellId) * grid->stride * (height + 2);
+    if (posix_memalign((void**) &(grid->cells), GRID_ALIGN, bytes) != 0) {
+        free(grid);
+        return NULL;
+    }
+    memset(grid->cells, 0, bytes);
+
+    return grid;
+}
+
+/**
+ * Frees a grid
+ */
+void s4354198_grid_free(Grid* grid) {
+    free(grid->cells);
+    free(grid);
+}
+
+/**
+ * Kills every cell in the grid
+ */
+void s4354198_grid_clear(Grid* grid) {
+    memset(grid->cells, 0, sizeof(CellId) * grid->stride * (grid->height + 2));
+}
+
+/**
+ * Copies one grid over another of the same size
+ */
+void s4354198_grid_copy(Grid* dest, Grid* src) {
+    memcpy(dest->cells, src->cells, sizeof(CellId) * src->stride * (src->height + 2));
+}
+
+/**
+ * Replaces every id in the grid with remap[id]
+ */
+void s4354198_grid_remap(Grid* grid, const CellId* remap) {
+    size_t cells = (size_t) grid->stride * (grid->height + 2);
+
+    for (size_t i = 0; i < cells; i++) {
+        grid->cells[i] = remap[grid->cells[i]];
+    }
+}
+
+/**
+ * Fills the ghost cells from the opposite edges, so the kernels step the
+ * board as a torus without knowing about it
+ */
+void s4354198_grid_wrap(Grid* grid) {
+    int width = grid->width;
+    int height = grid->height;
+
+    for (int y = 0; y < height; y++) {
+        CellId* row = s4354198_grid_row(grid, y);
+
+        row[-1] = row[width - 1];
+        row[width] = row[0];
+    }
+
+    // Whole rows including their ghosts, which also fills the corners
+    memcpy(s4354198_grid_row(grid, -1) - 1, s4354198_grid_row(grid, height - 1) - 1, 
+        sizeof(CellId) * (width + 2));
+    memcpy(s4354198_grid_row(grid, height) - 1, s4354198_grid_row(grid, 0) - 1,
+        sizeof(CellId) * (width + 2));
+}
+
+/**
+ * Computes one row of the next generation into newGrid
+ */
+void s4354198_grid_step_row(Grid* oldGrid, Grid* newGrid, int row) {
+    s4354198_grid_step_span(oldGrid, newGrid, row, 0, oldGrid->width);
+}
+
+/**
+ * Computes cells [xStart, xEnd) of one row of the next generation
+ */
+void s4354198_grid_step_span(Grid* oldGrid, Grid* newGrid, int row, int xStart, int xEnd) {
+    stepRow(s4354198_grid_row(oldGrid, row - 1) + xStart, 
+        s4354198_grid_row(oldGrid, row) + xStart,
+        s4354198_grid_row(oldGrid, row + 1) + xStart, 
+        s4354198_grid_row(newGrid, row) + xStart, xEnd - xStart);
+}
+
+/**
+ * Computes a block of the board several generations on while it is in 
+ * cache. The block and a halo as deep as the number of generations are
+ * copied into the first of two scratch grids, which must be that much 
+ * bigger than the block all round. They are then stepped in turn over a 
+ * region one cell smaller each generation, and the block is written into
+ * the new grid. Cells off the board stay dead. Returns true if the block
+ * changed in the last of the generations.
+ */
+bool s4354198_grid_step_block(Grid* oldGrid, Grid* newGrid, Grid** scratch, int rowStart,
+        int rowEnd, int xStart, int xEnd, int generations) {
+    // Board position of the scratch grids' first cell
+    int top = rowStart - generations;
+    int left = xStart - generations;
+    int loadStart = (top > 0) ? top : 0;
+    int loadEnd = (rowEnd + generations < oldGrid->height) ? rowEnd + generations : 
+        oldGrid->height;
+    int loadLeft = (left > 0) ? left : 0;
+    int loadRight = (xEnd + generations < oldGrid->width) ? xEnd + generations : 
+        oldGrid->width;
+
+    s4354198_grid_clear(scratch[0]);
+    s4354198_grid_clear(scratch[1]);
+    for (int y = loadStart; y < loadEnd; y++) {
+        memcpy(s4354198_grid_row(scratch[0], y - top) + (loadLeft - left), 
+            s4354198_grid_row(oldGrid, y) + loadLeft, sizeof(CellId) * (loadRight - loadLeft));
+    }
+
+    int current = 0;
+    for (int halo = generations - 1; halo >= 0; halo--) {
+        int y0 = (rowStart - halo > loadStart) ? rowStart - halo : loadStart;
+        int y1 = (rowEnd + halo < loadEnd) ? rowEnd + halo : loadEnd;
+        int x0 = (xStart - halo > loadLeft) ? xStart - halo : loadLeft;
+        int x1 = (xEnd + halo < loadRight) ? xEnd + halo : loadRight;
+
+        for (int y = y0; y < y1; y++) {
+            s4354198_grid_step_span(scratch[current], scratch[1 - current], y - top, 
+                x0 - left, x1 - left);
+        }
+        current = 1 - current;
+    }
+
+    bool changed = false;
+    for (int y = rowStart; y < rowEnd; y++) {
+        CellId* last = s4354198_grid_row(scratch[current], y - top) + (xStart - left);
+        CellId* before = s4354198_grid_row(scratch[1 - current], y - top) + (xStart - left);
+
+        changed = changed || memcmp(last, before, sizeof(CellId) * (xEnd - xStart)) != 0;
+        memcpy(s4354198_grid_row(newGrid, y) + xStart, last, sizeof(CellId) * (xEnd - xStart));
+    }
+
+    return changed;
+}
+
+/**
+ * Gets the name of the kernel being used
+ */
+const char* s4354198_grid_kernel_name(void) {
+    select_kernel();
+
+    return stepRowName;
+}
+
+/**
+ * Restricts the grids to the named kernel, so kernels can be compared on
+ * the same board. Returns false if the kernel is unknown or this CPU
+ * cannot run it.
+ */
+bool s4354198_grid_use_kernel(const char* name) {
+    for (int i = 0; i < sizeof(kernelNames) / sizeof(kernelNames[0]); i++) {
+        if (strcmp(name, kernelNames[i]) == 0) {
+            widestKernel = i;
+            stepRow = NULL;
+            select_kernel();
+
+            return strcmp(stepRowName, name) == 0;
+        }
+    }
+
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "s4354198_rule.h"
+
+/* Defines */
+#define GRID_ALIGN 64
+// Cells per cache line, used to pad rows so every row starts aligned
+#define GRID_PAD 32
+
+/* Compact lifeform id held by each cell, 0 is a dead cell */
+typedef uint16_t CellId;
+
+/*
+ * A board generation stored in one aligned block. Each row is padded out
+ * to a whole number of cache lines and there is a ghost cell either side
+ * of every row and a ghost row above and below the board. Ghosts are
+ * always dead, so neighbour lookups never need to be bounds checked.
+ */
+typedef struct {
+    int width;
+    int height;
+    int stride;
+    CellId* cells;
+} Grid;
+
+/* Function prototypes */
+Grid* s4354198_grid_create(int width, int height);
+void s4354198_grid_free(Grid* grid);
+void s4354198_grid_clear(Grid* grid);
+void s4354198_grid_copy(Grid* dest, Grid* src);
+void s4354198_grid_remap(Grid* grid, const CellId* remap);
+void s4354198_grid_wrap(Grid* grid);
+void s4354198_grid_step_row(Grid* oldGrid, Grid* newGrid, int row);
+void s4354198_grid_step_span(Grid* oldGrid, Grid* newGrid, int row, int xStart, int xEnd);
+bool s4354198_grid_step_block(Grid* oldGrid, Grid* newGrid, Grid** scratch, int rowStart,
+    int rowEnd, int xStart, int xEnd, int generations);
+void s4354198_grid_set_rule(const Rule* rule);
+const char* s4354198_grid_kernel_name(void);
+bool s4354198_grid_use_kernel(const char* name);
+
+/**
+ * Gets the first cell of row y. Index -1 and width are ghost cells, and
+ * rows -1 and height are ghost rows.
+ */
+static inline CellId* s4354198_grid_row(Grid* grid, int y) {
+    return grid->cells + (y + 1) * grid->stride + GRID_PAD;
+}
+
+#endif
\ No newline at end of file
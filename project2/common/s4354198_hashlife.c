@@ -0,0 +1,774 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s4354198_hashlife.h"
+
+/* Function prototypes */
+static HashNode* new_node(Hashlife* life);
+static HashNode* find_node(Hashlife* life, HashNode* nw, HashNode* ne, 
+    HashNode* sw, HashNode* se);
+static size_t hash_children(HashNode* nw, HashNode* ne, HashNode* sw, HashNode* se);
+static void grow_table(Hashlife* life);
+static HashNode* expand(Hashlife* life, HashNode* node);
+static bool centred(Hashlife* life, HashNode* node);
+static HashNode* set_cell(Hashlife* life, HashNode* node, int64_t x, int64_t y, bool alive);
+static HashNode* stamp_node(Hashlife* life, HashNode* node, Pattern* pattern, int64_t x, 
+    int64_t y, bool alive);
+static bool pattern_touches(Pattern* pattern, int64_t x, int64_t y, int level);
+static HashNode* successor(Hashlife* life, HashNode* node, int stepLog);
+static HashNode* step_4x4(Hashlife* life, HashNode* node);
+static void mark_node(Hashlife* life, HashNode* node);
+static void forget_past(Hashlife* life, int count);
+static uint32_t save_node(Hashlife* life, HashNode* node, FILE* file, uint32_t* count);
+static void capture_row(HashNode* node, int64_t nodeX, int64_t nodeY, int64_t y, 
+    int64_t left, int64_t right, CellId id, CellId* row);
+
+/**
+ * Creates an empty universe that collects its node cache once it holds 
+ * more than nodeLimit nodes
+ */
+Hashlife* s4354198_hashlife_create(size_t nodeLimit) {
+    Hashlife* life = (Hashlife*) malloc(sizeof(Hashlife));
+    life->bucketCount = 1 << 16;
+    life->buckets = (HashNode**) calloc(life->bucketCount, sizeof(HashNode*));
+    life->nodeCount = 0;
+    life->nodeLimit = nodeLimit;
+    life->freeNodes = NULL;
+    life->chunkCount = 0;
+    life->chunkCapacity = 16;
+    life->chunks = (HashNode**) malloc(sizeof(HashNode*) * life->chunkCapacity);
+    life->stepLog = 0;
+    life->epoch = 1;
+    life->markEpoch = 0;
+    life->collections = 0;
+    life->idCapacity = 16;
+    life->ids = (int*) malloc(sizeof(int) * life->idCapacity);
+    s4354198_rule_parse(RULE_CONWAY, &(life->rule));
+
+    // The two single cells live outside the hash table
+    life->empty[0] = (HashNode*) calloc(1, sizeof(HashNode));
+    life->alive = (HashNode*) calloc(1, sizeof(HashNode));
+    life->alive->population = 1;
+    life->alive->serial = 1;
+    life->nextSerial = 2;
+
+    for (int i = 1; i <= HASHLIFE_MAX_LEVEL; i++) {
+        HashNode* below = life->empty[i - 1];
+        life->empty[i] = find_node(life, below, below, below, below);
+    }
+
+    s4354198_hashlife_clear(life);
+
+    return life;
+}
+
+/**
+ * Kills every cell, forgets the drawn ids and resets the generation
+ */
+void s4354198_hashlife_clear(Hashlife* life) {
+    life->root = life->empty[3];
+    life->generation = 0;
+    life->idCount = 0;
+    life->pastFirst = 0;
+    life->pastCount = 0;
+}
+
+/**
+ * Sets the liveness of a cell, growing the universe to reach it
+ */
+void s4354198_hashlife_set(Hashlife* life, int64_t x, int64_t y, bool alive) {
+    while (life->root->level < HASHLIFE_MAX_LEVEL) {
+        int64_t half = (int64_t) 1 << (life->root->level - 1);
+
+        if (x >= -half && x < half && y >= -half && y < half) {
+            break;
+        }
+        life->root = expand(life, life->root);
+    }
+
+    int64_t half = (int64_t) 1 << (life->root->level - 1);
+    life->root = set_cell(life, life->root, x + half, y + half, alive);
+}
+
+/**
+ * Sets the cells a pattern has alive, with its top left corner at x and y,
+ * growing the universe to reach them. Squares the pattern is dead across 
+ * are kept, so only the nodes it draws on are rebuilt.
+ */
+void s4354198_hashlife_stamp(Hashlife* life, Pattern* pattern, int64_t x, int64_t y, bool alive) {
+    while (life->root->level < HASHLIFE_MAX_LEVEL) {
+        int64_t half = (int64_t) 1 << (life->root->level - 1);
+
+        if (x >= -half && x + pattern->width <= half && y >= -half && 
+                y + pattern->height <= half) {
+            break;
+        }
+        life->root = expand(life, life->root);
+    }
+
+    int64_t half = (int64_t) 1 << (life->root->level - 1);
+    life->root = stamp_node(life, life->root, pattern, x + half, y + half, alive);
+}
+
+/**
+ * Gets a value that is the same for two generations exactly when their
+ * universes are. Nodes are canonical and a serial is never reused, so the
+ * smallest centred node holding the whole pattern identifies it.
+ */
+uint64_t s4354198_hashlife_signature(Hashlife* life) {
+    HashNode* node = life->root;
+
+    while (node->level > 3) {
+        HashNode** c = node->child;
+        HashNode* centre = find_node(life, c[HASHLIFE_NW]->child[HASHLIFE_SE], 
+            c[HASHLIFE_NE]->child[HASHLIFE_SW], c[HASHLIFE_SW]->child[HASHLIFE_NE], 
+            c[HASHLIFE_SE]->child[HASHLIFE_NW]);
+
+        if (centre->population != node->population) {
+            break;
+        }
+        node = centre;
+    }
+
+    return node->serial;
+}
+
+/**
+ * Changes the rule the universe is stepped with
+ */
+void s4354198_hashlife_set_rule(Hashlife* life, const Rule* rule) {
+    life->rule = *rule;
+    // Results worked out under the old rule no longer apply
+    life->epoch++;
+}
+
+/**
+ * Advances the universe 2^stepLog generations. Returns false if the 
+ * pattern has grown too big to step that far.
+ */
+bool s4354198_hashlife_step(Hashlife* life, int stepLog) {
+    // Cached results are only valid for the step size they were made with
+    if (stepLog != life->stepLog) {
+        life->stepLog = stepLog;
+        life->epoch++;
+    }
+
+    if (life->root->population > 0) {
+        // Pad the pattern out until nothing can escape the returned centre
+        while (life->root->level < stepLog + 3 || !centred(life, life->root)) {
+            if (life->root->level == HASHLIFE_MAX_LEVEL) {
+                return false;
+            }
+            life->root = expand(life, life->root);
+        }
+
+        life->root = successor(life, life->root, stepLog);
+    }
+
+    life->generation += (uint64_t) 1 << stepLog;
+
+    if (life->nodeCount > life->nodeLimit) {
+        s4354198_hashlife_collect(life);
+    }
+
+    return true;
+}
+
+/**
+ * Frees every node that is no longer part of the universe, along with 
+ * any cached results that pointed at them
+ */
+void s4354198_hashlife_collect(Hashlife* life) {
+    life->markEpoch++;
+    life->collections++;
+
+    mark_node(life, life->root);
+    for (int i = 1; i <= HASHLIFE_MAX_LEVEL; i++) {
+        mark_node(life, life->empty[i]);
+    }
+    for (int i = 0; i < life->pastCount; i++) {
+        mark_node(life, life->past[(life->pastFirst + i) % HASHLIFE_PAST_ROOTS]);
+    }
+
+    for (size_t i = 0; i < life->bucketCount; i++) {
+        HashNode** link = &(life->buckets[i]);
+
+        while (*link != NULL) {
+            HashNode* node = *link;
+
+            if (node->mark != life->markEpoch) {
+                *link = node->next;
+                node->next = life->freeNodes;
+                life->freeNodes = node;
+                life->nodeCount--;
+            } else {
+                if (node->result != NULL && node->result->mark != life->markEpoch) {
+                    node->result = NULL;
+                }
+                link = &(node->next);
+            }
+        }
+    }
+
+    // Past roots give way, oldest first, when they hold most of the cache
+    if (life->nodeCount > life->nodeLimit / 2 && life->pastCount > 1) {
+        forget_past(life, life->pastCount / 2);
+        s4354198_hashlife_collect(life);
+    }
+}
+
+/**
+ * Writes the distinct nodes of the universe to a file, children first, 
+ * as the four indices of their children. Index 0 is a dead cell and 1 a
+ * live one, and the root is written last. Returns the number of nodes 
+ * written.
+ */
+uint32_t s4354198_hashlife_save(Hashlife* life, FILE* file) {
+    uint32_t count = 2;
+
+    // Saving marks nodes as it goes, like a collection does
+    life->markEpoch++;
+    save_node(life, life->root, file, &count);
+
+    return count - 2;
+}
+
+/**
+ * Rebuilds the universe from nodes written by s4354198_hashlife_save. 
+ * Returns false if they do not make a valid universe.
+ */
+bool s4354198_hashlife_load(Hashlife* life, const uint32_t* nodes, uint32_t count) {
+    HashNode** built = (HashNode**) malloc(sizeof(HashNode*) * (count + 2));
+    bool valid = count > 0;
+
+    built[0] = life->empty[0];
+    built[1] = life->alive;
+
+    for (uint32_t i = 0; i < count && valid; i++) {
+        const uint32_t* child = &nodes[i * 4];
+
+        // Children come first and all four must be the same size
+        for (int j = 0; j < 4; j++) {
+            valid = valid && child[j] < i + 2 && 
+                built[child[j]]->level == built[child[0]]->level;
+        }
+        if (valid && built[child[0]]->level < HASHLIFE_MAX_LEVEL) {
+            built[i + 2] = find_node(life, built[child[0]], built[child[1]], 
+                built[child[2]], built[child[3]]);
+        } else {
+            valid = false;
+        }
+    }
+
+    if (valid && built[count + 1]->level >= 3) {
+        s4354198_hashlife_clear(life);
+        life->root = built[count + 1];
+    } else {
+        valid = false;
+    }
+    free(built);
+
+    return valid;
+}
+
+/**
+ * Remembers the root as it is at a generation, replacing what was last
+ * remembered if it was for the same generation
+ */
+void s4354198_hashlife_remember(Hashlife* life, uint64_t generation) {
+    int last = (life->pastFirst + life->pastCount - 1) % HASHLIFE_PAST_ROOTS;
+
+    if (life->pastCount > 0 && life->pastGenerations[last] == generation) {
+        life->past[last] = life->root;
+        return;
+    }
+
+    if (life->pastCount == HASHLIFE_PAST_ROOTS) {
+        forget_past(life, 1);
+    }
+
+    int slot = (life->pastFirst + life->pastCount++) % HASHLIFE_PAST_ROOTS;
+    life->past[slot] = life->root;
+    life->pastGenerations[slot] = generation;
+}
+
+/**
+ * Goes back to the newest remembered root at or before a generation, 
+ * forgetting the ones after it. Returns false if that far back is no 
+ * longer remembered, otherwise found is set to its generation.
+ */
+bool s4354198_hashlife_recall(Hashlife* life, uint64_t generation, uint64_t* found) {
+    for (int i = life->pastCount - 1; i >= 0; i--) {
+        int slot = (life->pastFirst + i) % HASHLIFE_PAST_ROOTS;
+
+        if (life->pastGenerations[slot] <= generation) {
+            life->root = life->past[slot];
+            life->pastCount = i + 1;
+            *found = life->pastGenerations[slot];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Copies a window of the universe into width * height cells, row after
+ * row, with every live cell given the same id. Empty parts of the tree 
+ * are skipped, so the cost follows the number of live cells in the window.
+ */
+void s4354198_hashlife_capture(Hashlife* life, int64_t left, int64_t top, int width, 
+        int height, CellId id, CellId* cells) {
+    int64_t half = (int64_t) 1 << (life->root->level - 1);
+
+    memset(cells, 0, sizeof(CellId) * (size_t) width * height);
+
+    for (int i = 0; i < height; i++) {
+        capture_row(life->root, -half, -half, top + i, left, left + width, id, 
+            cells + (size_t) i * width);
+    }
+}
+
+/**
+ * Remembers that a lifeform id was drawn into the universe
+ */
+void s4354198_hashlife_add_id(Hashlife* life, int id) {
+    for (int i = 0; i < life->idCount; i++) {
+        if (life->ids[i] == id) {
+            return;
+        }
+    }
+
+    if (life->idCount == life->idCapacity) {
+        life->idCapacity *= 2;
+        life->ids = (int*) realloc(life->ids, sizeof(int) * life->idCapacity);
+    }
+    life->ids[life->idCount++] = id;
+}
+
+/**
+ * Gets the highest id drawn into the universe, which is the id any
+ * merged lifeform would end up with. Returns 0 if there are none.
+ */
+int s4354198_hashlife_highest_id(Hashlife* life) {
+    int highest = 0;
+
+    for (int i = 0; i < life->idCount; i++) {
+        if (life->ids[i] > highest) {
+            highest = life->ids[i];
+        }
+    }
+
+    return highest;
+}
+
+/**
+ * Takes a node off the free list, carving up a new chunk if needed
+ */
+static HashNode* new_node(Hashlife* life) {
+    if (life->freeNodes == NULL) {
+        HashNode* chunk = (HashNode*) malloc(sizeof(HashNode) * HASHLIFE_CHUNK_NODES);
+
+        if (life->chunkCount == life->chunkCapacity) {
+            life->chunkCapacity *= 2;
+            life->chunks = (HashNode**) realloc(life->chunks, 
+                sizeof(HashNode*) * life->chunkCapacity);
+        }
+        life->chunks[life->chunkCount++] = chunk;
+
+        for (int i = 0; i < HASHLIFE_CHUNK_NODES; i++) {
+            chunk[i].next = life->freeNodes;
+            life->freeNodes = &(chunk[i]);
+        }
+    }
+
+    HashNode* node = life->freeNodes;
+    life->freeNodes = node->next;
+
+    return node;
+}
+
+/**
+ * Mixes the child pointers of a node into a hash
+ */
+static size_t hash_children(HashNode* nw, HashNode* ne, HashNode* sw, HashNode* se) {
+    uint64_t hash = (uint64_t) (uintptr_t) nw * 0x9E3779B97F4A7C15ULL;
+
+    hash ^= (uint64_t) (uintptr_t) ne * 0xC2B2AE3D27D4EB4FULL;
+    hash ^= (uint64_t) (uintptr_t) sw * 0x165667B19E3779F9ULL;
+    hash ^= (uint64_t) (uintptr_t) se * 0x27D4EB2F165667C5ULL;
+
+    return (size_t) (hash ^ (hash >> 29));
+}
+
+/**
+ * Gets the canonical node with the given children
+ */
+static HashNode* find_node(Hashlife* life, HashNode* nw, HashNode* ne, 
+        HashNode* sw, HashNode* se) {
+    size_t bucket = hash_children(nw, ne, sw, se) & (life->bucketCount - 1);
+
+    for (HashNode* node = life->buckets[bucket]; node != NULL; node = node->next) {
+        if (node->child[HASHLIFE_NW] == nw && node->child[HASHLIFE_NE] == ne &&
+                node->child[HASHLIFE_SW] == sw && node->child[HASHLIFE_SE] == se) {
+            return node;
+        }
+    }
+
+    HashNode* node = new_node(life);
+    node->child[HASHLIFE_NW] = nw;
+    node->child[HASHLIFE_NE] = ne;
+    node->child[HASHLIFE_SW] = sw;
+    node->child[HASHLIFE_SE] = se;
+    node->result = NULL;
+    node->resultEpoch = 0;
+    node->mark = 0;
+    node->level = nw->level + 1;
+    node->serial = life->nextSerial++;
+
+    // Saturate rather than wrap on absurdly large populations
+    node->population = nw->population;
+    HashNode* others[3] = {ne, sw, se};
+    for (int i = 0; i < 3; i++) {
+        uint64_t sum = node->population + others[i]->population;
+        node->population = (sum < node->population) ? UINT64_MAX : sum;
+    }
+
+    node->next = life->buckets[bucket];
+    life->buckets[bucket] = node;
+    life->nodeCount++;
+
+    if (life->nodeCount > life->bucketCount) {
+        grow_table(life);
+    }
+
+    return node;
+}
+
+/**
+ * Doubles the number of hash buckets
+ */
+static void grow_table(Hashlife* life) {
+    size_t count = life->bucketCount * 2;
+    HashNode** buckets = (HashNode**) calloc(count, sizeof(HashNode*));
+
+    for (size_t i = 0; i < life->bucketCount; i++) {
+        HashNode* node = life->buckets[i];
+
+        while (node != NULL) {
+            HashNode* next = node->next;
+            size_t bucket = hash_children(node->child[HASHLIFE_NW], 
+                node->child[HASHLIFE_NE], node->child[HASHLIFE_SW], 
+                node->child[HASHLIFE_SE]) & (count - 1);
+
+            node->next = buckets[bucket];
+            buckets[bucket] = node;
+            node = next;
+        }
+    }
+
+    free(life->buckets);
+    life->buckets = buckets;
+    life->bucketCount = count;
+}
+
+/**
+ * Gets a node twice the size with the given node in its centre
+ */
+static HashNode* expand(Hashlife* life, HashNode* node) {
+    HashNode* empty = life->empty[node->level - 1];
+
+    return find_node(life,
+        find_node(life, empty, empty, empty, node->child[HASHLIFE_NW]),
+        find_node(life, empty, empty, node->child[HASHLIFE_NE], empty),
+        find_node(life, empty, node->child[HASHLIFE_SW], empty, empty),
+        find_node(life, node->child[HASHLIFE_SE], empty, empty, empty));
+}
+
+/**
+ * Checks that every live cell is in the middle quarter of a node, so 
+ * stepping it a quarter of its width cannot reach past its centre half
+ */
+static bool centred(Hashlife* life, HashNode* node) {
+    if (node->level < 3) {
+        return false;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        // Quadrant i touches the middle with its opposite corner
+        HashNode* quadrant = node->child[i];
+
+        for (int j = 0; j < 4; j++) {
+            if (j != 3 - i) {
+                if (quadrant->child[j] != life->empty[node->level - 2]) {
+                    return false;
+                }
+                continue;
+            }
+
+            for (int k = 0; k < 4; k++) {
+                if (k != 3 - i && 
+                        quadrant->child[j]->child[k] != life->empty[node->level - 3]) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Rebuilds the path to a cell, with x and y relative to the node's 
+ * top left corner
+ */
+static HashNode* set_cell(Hashlife* life, HashNode* node, int64_t x, int64_t y, bool alive) {
+    if (node->level == 0) {
+        return alive ? life->alive : life->empty[0];
+    }
+
+    int64_t half = (int64_t) 1 << (node->level - 1);
+    int quadrant = (y >= half) * 2 + (x >= half);
+    HashNode* children[4];
+
+    memcpy(children, node->child, sizeof(children));
+    children[quadrant] = set_cell(life, children[quadrant], 
+        x - (x >= half) * half, y - (y >= half) * half, alive);
+
+    return find_node(life, children[HASHLIFE_NW], children[HASHLIFE_NE], 
+        children[HASHLIFE_SW], children[HASHLIFE_SE]);
+}
+
+/**
+ * Rebuilds a node with a pattern drawn on it, with the pattern's top left
+ * corner at x and y relative to the node's
+ */
+static HashNode* stamp_node(Hashlife* life, HashNode* node, Pattern* pattern, int64_t x, 
+        int64_t y, bool alive) {
+    int64_t size = (int64_t) 1 << node->level;
+
+    if (x >= size || y >= size || x + pattern->width <= 0 || y + pattern->height <= 0) {
+        return node;
+    }
+
+    if (node->level <= HASHLIFE_STAMP_LEVEL && !pattern_touches(pattern, x, y, node->level)) {
+        return node;
+    }
+
+    if (node->level == 0) {
+        return alive ? life->alive : life->empty[0];
+    }
+
+    int64_t half = size / 2;
+
+    return find_node(life, 
+        stamp_node(life, node->child[HASHLIFE_NW], pattern, x, y, alive),
+        stamp_node(life, node->child[HASHLIFE_NE], pattern, x - half, y, alive),
+        stamp_node(life, node->child[HASHLIFE_SW], pattern, x, y - half, alive),
+        stamp_node(life, node->child[HASHLIFE_SE], pattern, x - half, y - half, alive));
+}
+
+/**
+ * Checks if a pattern has any live cells in a node no wider than a word,
+ * with the pattern's top left corner at x and y relative to the node's
+ */
+static bool pattern_touches(Pattern* pattern, int64_t x, int64_t y, int level) {
+    int size = 1 << level;
+    uint64_t mask = (size == PATTERN_WORD_BITS) ? ~0ULL : ((1ULL << size) - 1);
+    int rowStart = (y > 0) ? (int) y : 0;
+    int rowEnd = (y + pattern->height < size) ? (int) (y + pattern->height) : size;
+
+    for (int row = rowStart; row < rowEnd; row++) {
+        if (s4354198_pattern_bits(pattern, (int) (row - y), (int) -x) & mask) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Gets the centre half of a node advanced 2^stepLog generations, or as
+ * far as it can go (a quarter of its width) when that is less
+ */
+static HashNode* successor(Hashlife* life, HashNode* node, int stepLog) {
+    if (node->population == 0) {
+        return life->empty[node->level - 1];
+    }
+
+    if (node->result != NULL && node->resultEpoch == life->epoch) {
+        return node->result;
+    }
+
+    HashNode* result;
+
+    if (node->level == 2) {
+        result = step_4x4(life, node);
+    } else {
+        HashNode** c = node->child;
+        HashNode* parts[9];
+        HashNode* sub[9];
+
+        // Nine overlapping squares each half the size of this node
+        parts[0] = c[HASHLIFE_NW];
+        parts[1] = find_node(life, c[HASHLIFE_NW]->child[HASHLIFE_NE], 
+            c[HASHLIFE_NE]->child[HASHLIFE_NW], c[HASHLIFE_NW]->child[HASHLIFE_SE], 
+            c[HASHLIFE_NE]->child[HASHLIFE_SW]);
+        parts[2] = c[HASHLIFE_NE];
+        parts[3] = find_node(life, c[HASHLIFE_NW]->child[HASHLIFE_SW], 
+            c[HASHLIFE_NW]->child[HASHLIFE_SE], c[HASHLIFE_SW]->child[HASHLIFE_NW], 
+            c[HASHLIFE_SW]->child[HASHLIFE_NE]);
+        parts[4] = find_node(life, c[HASHLIFE_NW]->child[HASHLIFE_SE], 
+            c[HASHLIFE_NE]->child[HASHLIFE_SW], c[HASHLIFE_SW]->child[HASHLIFE_NE], 
+            c[HASHLIFE_SE]->child[HASHLIFE_NW]);
+        parts[5] = find_node(life, c[HASHLIFE_NE]->child[HASHLIFE_SW], 
+            c[HASHLIFE_NE]->child[HASHLIFE_SE], c[HASHLIFE_SE]->child[HASHLIFE_NW], 
+            c[HASHLIFE_SE]->child[HASHLIFE_NE]);
+        parts[6] = c[HASHLIFE_SW];
+        parts[7] = find_node(life, c[HASHLIFE_SW]->child[HASHLIFE_NE], 
+            c[HASHLIFE_SE]->child[HASHLIFE_NW], c[HASHLIFE_SW]->child[HASHLIFE_SE], 
+            c[HASHLIFE_SE]->child[HASHLIFE_SW]);
+        parts[8] = c[HASHLIFE_SE];
+
+        for (int i = 0; i < 9; i++) {
+            sub[i] = successor(life, parts[i], stepLog);
+        }
+
+        // Each group of four overlapping results makes a quadrant
+        int corners[4] = {0, 1, 3, 4};
+        HashNode* quadrants[4];
+        for (int i = 0; i < 4; i++) {
+            int k = corners[i];
+
+            if (stepLog >= node->level - 2) {
+                // Full speed, step the quadrant a second time
+                quadrants[i] = successor(life, find_node(life, sub[k], sub[k + 1], 
+                    sub[k + 3], sub[k + 4]), stepLog);
+            } else {
+                // Only the centre is wanted, without stepping further
+                quadrants[i] = find_node(life, sub[k]->child[HASHLIFE_SE], 
+                    sub[k + 1]->child[HASHLIFE_SW], sub[k + 3]->child[HASHLIFE_NE], 
+                    sub[k + 4]->child[HASHLIFE_NW]);
+            }
+        }
+
+        result = find_node(life, quadrants[HASHLIFE_NW], quadrants[HASHLIFE_NE], 
+            quadrants[HASHLIFE_SW], quadrants[HASHLIFE_SE]);
+    }
+
+    node->result = result;
+    node->resultEpoch = life->epoch;
+
+    return result;
+}
+
+/**
+ * Steps the centre 2x2 of a 4x4 node a single generation
+ */
+static HashNode* step_4x4(Hashlife* life, HashNode* node) {
+    bool cells[4][4];
+    HashNode* centre[4];
+
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            HashNode* quadrant = node->child[(y / 2) * 2 + x / 2];
+
+            cells[y][x] = quadrant->child[(y % 2) * 2 + x % 2]->population != 0;
+        }
+    }
+
+    for (int y = 1; y <= 2; y++) {
+        for (int x = 1; x <= 2; x++) {
+            int neighbours = 0;
+
+            for (int i = y - 1; i <= y + 1; i++) {
+                for (int j = x - 1; j <= x + 1; j++) {
+                    neighbours += cells[i][j];
+                }
+            }
+            neighbours -= cells[y][x];
+
+            bool alive = s4354198_rule_lives(&(life->rule), cells[y][x], neighbours);
+            centre[(y - 1) * 2 + (x - 1)] = alive ? life->alive : life->empty[0];
+        }
+    }
+
+    return find_node(life, centre[HASHLIFE_NW], centre[HASHLIFE_NE], 
+        centre[HASHLIFE_SW], centre[HASHLIFE_SE]);
+}
+
+/**
+ * Marks a node and everything below it as still in use
+ */
+static void mark_node(Hashlife* life, HashNode* node) {
+    if (node->level == 0 || node->mark == life->markEpoch) {
+        return;
+    }
+
+    node->mark = life->markEpoch;
+    for (int i = 0; i < 4; i++) {
+        mark_node(life, node->child[i]);
+    }
+}
+
+/**
+ * Sets the live cells of one row of a node that fall in [left, right),
+ * where row holds cell left onwards
+ */
+static void capture_row(HashNode* node, int64_t nodeX, int64_t nodeY, int64_t y, 
+        int64_t left, int64_t right, CellId id, CellId* row) {
+    int64_t size = (int64_t) 1 << node->level;
+
+    if (node->population == 0 || y < nodeY || y >= nodeY + size || 
+            nodeX >= right || nodeX + size <= left) {
+        return;
+    }
+
+    if (node->level == 0) {
+        row[nodeX - left] = id;
+        return;
+    }
+
+    int64_t half = size / 2;
+    int south = (y >= nodeY + half);
+    int64_t top = nodeY + south * half;
+
+    capture_row(node->child[south * 2], nodeX, top, y, left, right, id, row);
+    capture_row(node->child[south * 2 + 1], nodeX + half, top, y, left, right, id, row);
+}
+
+/**
+ * Forgets the oldest remembered roots
+ */
+static void forget_past(Hashlife* life, int count) {
+    life->pastFirst = (life->pastFirst + count) % HASHLIFE_PAST_ROOTS;
+    life->pastCount -= count;
+}
+
+/**
+ * Writes a node after its children, unless it has already been written,
+ * and returns its index
+ */
+static uint32_t save_node(Hashlife* life, HashNode* node, FILE* file, uint32_t* count) {
+    uint32_t children[4];
+
+    if (node->level == 0) {
+        return (node == life->alive) ? 1 : 0;
+    }
+    if (node->mark == life->markEpoch) {
+        return node->saved;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        children[i] = save_node(life, node->child[i], file, count);
+    }
+    fwrite(children, sizeof(uint32_t), 4, file);
+
+    node->mark = life->markEpoch;
+    node->saved = (*count)++;
+
+    return node->saved;
+}
\ No newline at end of file
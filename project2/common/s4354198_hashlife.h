@@ -0,0 +1,99 @@
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "s4354198_grid.h"
+#include "s4354198_rule.h"
+#include "s4354198_pattern.h"
+
+/* Defines */
+// Nodes kept between steps before the cache is collected, about 300MB
+#define HASHLIFE_DEFAULT_NODES (1 << 22)
+#define HASHLIFE_CHUNK_NODES 65536
+#define HASHLIFE_MAX_LEVEL 62
+// Past roots remembered for rewinding, as long as the cache has room
+#define HASHLIFE_PAST_ROOTS 1024
+// Nodes this small are checked for live pattern cells before being stamped
+#define HASHLIFE_STAMP_LEVEL 6
+#define HASHLIFE_NW 0
+#define HASHLIFE_NE 1
+#define HASHLIFE_SW 2
+#define HASHLIFE_SE 3
+
+/*
+ * A square of 2^level cells on a side. Nodes are canonical, so two equal
+ * squares anywhere in space or time are the same node and the result of
+ * stepping one is only ever worked out once. Level 0 nodes are single
+ * cells.
+ */
+typedef struct HashNode {
+    struct HashNode* child[4];
+    struct HashNode* result;
+    struct HashNode* next;
+    uint64_t population;
+    uint64_t serial;
+    int level;
+    unsigned int resultEpoch;
+    unsigned int mark;
+    // Index given out while the universe is being saved
+    uint32_t saved;
+} HashNode;
+
+/*
+ * An unbounded universe stepped with Gosper's Hashlife. The root is 
+ * centred on the origin and grows as the pattern does. Lifeform ids are
+ * not tracked per cell, just which ids were drawn since the universe 
+ * last emptied. Past roots can be remembered to rewind to later, which 
+ * costs next to nothing as they share almost all of their nodes.
+ */
+typedef struct {
+    HashNode** buckets;
+    size_t bucketCount;
+    size_t nodeCount;
+    size_t nodeLimit;
+    HashNode* freeNodes;
+    HashNode** chunks;
+    int chunkCount;
+    int chunkCapacity;
+    HashNode* empty[HASHLIFE_MAX_LEVEL + 1];
+    HashNode* alive;
+    HashNode* root;
+    Rule rule;
+    int stepLog;
+    unsigned int epoch;
+    unsigned int markEpoch;
+    uint64_t generation;
+    unsigned long collections;
+    uint64_t nextSerial;
+    int* ids;
+    int idCount;
+    int idCapacity;
+    HashNode* past[HASHLIFE_PAST_ROOTS];
+    uint64_t pastGenerations[HASHLIFE_PAST_ROOTS];
+    int pastFirst;
+    int pastCount;
+} Hashlife;
+
+/* Function prototypes */
+Hashlife* s4354198_hashlife_create(size_t nodeLimit);
+void s4354198_hashlife_clear(Hashlife* life);
+void s4354198_hashlife_set_rule(Hashlife* life, const Rule* rule);
+void s4354198_hashlife_set(Hashlife* life, int64_t x, int64_t y, bool alive);
+void s4354198_hashlife_stamp(Hashlife* life, Pattern* pattern, int64_t x, int64_t y, bool alive);
+bool s4354198_hashlife_step(Hashlife* life, int stepLog);
+void s4354198_hashlife_collect(Hashlife* life);
+void s4354198_hashlife_remember(Hashlife* life, uint64_t generation);
+bool s4354198_hashlife_recall(Hashlife* life, uint64_t generation, uint64_t* found);
+uint64_t s4354198_hashlife_signature(Hashlife* life);
+void s4354198_hashlife_capture(Hashlife* life, int64_t left, int64_t top, int width, 
+    int height, CellId id, CellId* cells);
+void s4354198_hashlife_add_id(Hashlife* life, int id);
+uint32_t s4354198_hashlife_save(Hashlife* life, FILE* file);
+bool s4354198_hashlife_load(Hashlife* life, const uint32_t* nodes, uint32_t count);
+int s4354198_hashlife_highest_id(Hashlife* life);
+
+#endif
\ No newline at end of file
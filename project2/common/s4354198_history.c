@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "s4354198_history.h"
+
+/* Function prototypes */
+static void trim_entry(History* history, HistoryEntry* entry);
+static bool drop_oldest(History* history);
+
+/**
+ * Creates an empty history that keeps about budget bytes of entries
+ */
+History* s4354198_history_create(size_t budget) {
+    History* history = (History*) malloc(sizeof(History));
+    history->capacity = HISTORY_KEYFRAME_GAP;
+    history->entries = (HistoryEntry*) malloc(sizeof(HistoryEntry) * history->capacity);
+    history->count = 0;
+    history->bytes = 0;
+    history->budget = budget;
+
+    return history;
+}
+
+/**
+ * Forgets every entry, as when the board is cleared
+ */
+void s4354198_history_reset(History* history) {
+    s4354198_history_truncate(history, -1);
+}
+
+/**
+ * Starts a new newest entry for a generation. It is a keyframe if there
+ * is nothing to build on or the last keyframe is far enough back, in 
+ * which case the caller must push every live cell, otherwise just the
+ * cells that changed.
+ */
+HistoryEntry* s4354198_history_begin(History* history, unsigned long generation) {
+    if (history->count > 0) {
+        trim_entry(history, &(history->entries[history->count - 1]));
+    }
+
+    while (history->bytes > history->budget && drop_oldest(history)) {
+        ; // Keep dropping until under budget or only one keyframe is left
+    }
+
+    if (history->count == history->capacity) {
+        history->capacity *= 2;
+        history->entries = (HistoryEntry*) realloc(history->entries, 
+            sizeof(HistoryEntry) * history->capacity);
+    }
+
+    int last = history->count - 1;
+    HistoryEntry* entry = &(history->entries[history->count++]);
+    entry->generation = generation;
+    entry->keyframe = (last < 0) || 
+        (last - s4354198_history_keyframe(history, last) + 1 >= HISTORY_KEYFRAME_GAP);
+    entry->count = 0;
+    entry->capacity = HISTORY_INITIAL_RUNS;
+    entry->runs = (HistoryRun*) malloc(sizeof(HistoryRun) * entry->capacity);
+    history->bytes += sizeof(HistoryEntry) + sizeof(HistoryRun) * entry->capacity;
+
+    return entry;
+}
+
+/**
+ * Starts a new newest entry that is always a keyframe, for a generation
+ * that was reached without recording the ones in between
+ */
+HistoryEntry* s4354198_history_begin_keyframe(History* history, unsigned long generation) {
+    HistoryEntry* entry = s4354198_history_begin(history, generation);
+    entry->keyframe = true;
+
+    return entry;
+}
+
+/**
+ * Adds a run of cells to the newest entry, joining it onto the run before
+ * when they touch and share an id
+ */
+void s4354198_history_push(History* history, int x, int y, int length, int id) {
+    HistoryEntry* entry = s4354198_history_last(history);
+
+    if (entry->count > 0) {
+        HistoryRun* run = &(entry->runs[entry->count - 1]);
+
+        if (run->y == y && run->id == id && run->x + run->length == x) {
+            run->length += length;
+            return;
+        }
+    }
+
+    if (entry->count == entry->capacity) {
+        history->bytes += sizeof(HistoryRun) * entry->capacity;
+        entry->capacity *= 2;
+        entry->runs = (HistoryRun*) realloc(entry->runs, 
+            sizeof(HistoryRun) * entry->capacity);
+    }
+
+    entry->runs[entry->count++] = (HistoryRun) {
+        .x = x, 
+        .y = y, 
+        .length = length, 
+        .id = id
+    };
+}
+
+/**
+ * Gets the index of the newest entry at or before a generation, or -1 if
+ * that far back is no longer kept
+ */
+int s4354198_history_find(History* history, unsigned long generation) {
+    for (int i = history->count - 1; i >= 0; i--) {
+        if (history->entries[i].generation <= generation) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Gets the index of the keyframe an entry is rebuilt from
+ */
+int s4354198_history_keyframe(History* history, int index) {
+    while (!history->entries[index].keyframe) {
+        index--;
+    }
+
+    return index;
+}
+
+/**
+ * Drops every entry after index, as they are no longer the future once
+ * the board has been rewound to it
+ */
+void s4354198_history_truncate(History* history, int index) {
+    for (int i = index + 1; i < history->count; i++) {
+        HistoryEntry* entry = &(history->entries[i]);
+
+        history->bytes -= sizeof(HistoryEntry) + sizeof(HistoryRun) * entry->capacity;
+        free(entry->runs);
+    }
+
+    history->count = index + 1;
+}
+
+/**
+ * Counts the keyframes kept
+ */
+int s4354198_history_keyframes(History* history) {
+    int count = 0;
+
+    for (int i = 0; i < history->count; i++) {
+        count += history->entries[i].keyframe;
+    }
+
+    return count;
+}
+
+/**
+ * Gives back the spare room of an entry that is finished
+ */
+static void trim_entry(History* history, HistoryEntry* entry) {
+    int capacity = (entry->count > 0) ? entry->count : 1;
+
+    if (capacity == entry->capacity) {
+        return;
+    }
+
+    history->bytes -= sizeof(HistoryRun) * (entry->capacity - capacity);
+    entry->capacity = capacity;
+    entry->runs = (HistoryRun*) realloc(entry->runs, sizeof(HistoryRun) * capacity);
+}
+
+/**
+ * Drops the oldest keyframe and the deltas that need it. The newest
+ * keyframe is always kept so the current generation can be rebuilt.
+ * Returns false if there was nothing that could be dropped.
+ */
+static bool drop_oldest(History* history) {
+    int next = 1;
+
+    while (next < history->count && !history->entries[next].keyframe) {
+        next++;
+    }
+
+    if (next == history->count) {
+        return false;
+    }
+
+    for (int i = 0; i < next; i++) {
+        HistoryEntry* entry = &(history->entries[i]);
+
+        history->bytes -= sizeof(HistoryEntry) + sizeof(HistoryRun) * entry->capacity;
+        free(entry->runs);
+    }
+
+    history->count -= next;
+    memmove(history->entries, &(history->entries[next]), 
+        sizeof(HistoryEntry) * history->count);
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Defines */
+// Memory kept for past generations unless -H says otherwise, 0 turns it off
+#define HISTORY_DEFAULT_MEGABYTES 64
+#define HISTORY_MAX_MEGABYTES 4096
+// Generations between keyframes, so a rewind never replays more deltas
+#define HISTORY_KEYFRAME_GAP 64
+#define HISTORY_INITIAL_RUNS 16
+
+/*
+ * Cells along part of a row that all became the same lifeform id
+ */
+typedef struct {
+    int x;
+    int y;
+    int length;
+    int id;
+} HistoryRun;
+
+/*
+ * A generation as the runs of cells to write to reach it. Keyframes are
+ * written onto an empty board, every other entry onto the entry before.
+ */
+typedef struct {
+    unsigned long generation;
+    bool keyframe;
+    HistoryRun* runs;
+    int count;
+    int capacity;
+} HistoryEntry;
+
+/*
+ * Past generations, oldest first, kept within a memory budget. Ids are 
+ * stored as lifeform ids so renumbering the grid does not affect them. 
+ * Once over budget the oldest keyframe is dropped along with the deltas 
+ * built on it, so every entry left can still be rebuilt.
+ */
+typedef struct {
+    HistoryEntry* entries;
+    int count;
+    int capacity;
+    size_t bytes;
+    size_t budget;
+} History;
+
+/* Function prototypes */
+History* s4354198_history_create(size_t budget);
+void s4354198_history_reset(History* history);
+HistoryEntry* s4354198_history_begin(History* history, unsigned long generation);
+HistoryEntry* s4354198_history_begin_keyframe(History* history, unsigned long generation);
+void s4354198_history_push(History* history, int x, int y, int length, int id);
+int s4354198_history_find(History* history, unsigned long generation);
+int s4354198_history_keyframe(History* history, int index);
+void s4354198_history_truncate(History* history, int index);
+int s4354198_history_keyframes(History* history);
+
+/**
+ * Gets the newest entry, or NULL if nothing is kept
+ */
+static inline HistoryEntry* s4354198_history_last(History* history) {
+    return (history->count > 0) ? &(history->entries[history->count - 1]) : NULL;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "s4354198_idmap.h"
+
+/**
+ * Creates an id map that only knows about the dead id
+ */
+IdMap* s4354198_idmap_create(void) {
+    IdMap* map = (IdMap*) malloc(sizeof(IdMap));
+    map->capacity = 64;
+    map->toReal = (int*) malloc(sizeof(int) * map->capacity);
+    s4354198_idmap_reset(map);
+
+    return map;
+}
+
+/**
+ * Forgets every id apart from the dead id
+ */
+void s4354198_idmap_reset(IdMap* map) {
+    map->toReal[0] = 0;
+    map->count = 1;
+}
+
+/**
+ * Finds the compact id of a real id, or -1 if it has not been mapped
+ */
+int s4354198_idmap_find(IdMap* map, int realId) {
+    int low = 0;
+    int high = map->count - 1;
+
+    // Real ids are kept sorted, so binary search them
+    while (low <= high) {
+        int middle = (low + high) / 2;
+
+        if (map->toReal[middle] == realId) {
+            return middle;
+        } else if (map->toReal[middle] < realId) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Checks if a real id can be given the next compact id without 
+ * breaking the ordering or running out of room
+ */
+bool s4354198_idmap_can_append(IdMap* map, int realId) {
+    return map->count <= IDMAP_MAX_COMPACT && realId > map->toReal[map->count - 1];
+}
+
+/**
+ * Gives a real id the next compact id
+ */
+int s4354198_idmap_append(IdMap* map, int realId) {
+    if (map->count == map->capacity) {
+        map->capacity *= 2;
+        map->toReal = (int*) realloc(map->toReal, sizeof(int) * map->capacity);
+    }
+
+    map->toReal[map->count] = realId;
+    return map->count++;
+}
+
+/**
+ * Compare function for sorting real ids
+ */
+static int compare_ids(const void* a, const void* b) {
+    int first = *((const int*) a);
+    int second = *((const int*) b);
+
+    return (first > second) - (first < second);
+}
+
+/**
+ * Renumbers the map so it only holds the compact ids marked in keep plus
+ * extraId. remap is filled with the new compact id of every old compact
+ * id (0 for the dropped ones). Returns false if they do not all fit.
+ */
+bool s4354198_idmap_rebuild(IdMap* map, bool* keep, int extraId, uint16_t* remap) {
+    int* kept = (int*) malloc(sizeof(int) * (map->count + 1));
+    int keptCount = 0;
+
+    for (int i = 1; i < map->count; i++) {
+        if (keep[i]) {
+            kept[keptCount++] = map->toReal[i];
+        }
+    }
+    kept[keptCount++] = extraId;
+
+    if (keptCount > IDMAP_MAX_COMPACT) {
+        free(kept);
+        return false;
+    }
+
+    qsort(kept, keptCount, sizeof(int), &compare_ids);
+
+    // Old compact ids are renumbered through their real ids
+    int* oldToReal = (int*) malloc(sizeof(int) * map->count);
+    int oldCount = map->count;
+    memcpy(oldToReal, map->toReal, sizeof(int) * oldCount);
+
+    s4354198_idmap_reset(map);
+    for (int i = 0; i < keptCount; i++) {
+        if (s4354198_idmap_find(map, kept[i]) < 0) {
+            s4354198_idmap_append(map, kept[i]);
+        }
+    }
+
+    remap[0] = 0;
+    for (int i = 1; i < oldCount; i++) {
+        remap[i] = keep[i] ? (uint16_t) s4354198_idmap_find(map, oldToReal[i]) : 0;
+    }
+
+    free(oldToReal);
+    free(kept);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef IDMAP_H
+#define IDMAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines */
+// Compact ids fit in a 16 bit cell, with 0 kept for dead cells
+#define IDMAP_MAX_COMPACT 65535
+
+/*
+ * Maps lifeform ids onto the compact ids stored in the grid. Compact ids
+ * are handed out in the same order as the real ids, so the highest
+ * compact neighbour is always the highest real neighbour.
+ */
+typedef struct {
+    int count;
+    int capacity;
+    int* toReal;
+} IdMap;
+
+/* Function prototypes */
+IdMap* s4354198_idmap_create(void);
+void s4354198_idmap_reset(IdMap* map);
+int s4354198_idmap_find(IdMap* map, int realId);
+bool s4354198_idmap_can_append(IdMap* map, int realId);
+int s4354198_idmap_append(IdMap* map, int realId);
+bool s4354198_idmap_rebuild(IdMap* map, bool* keep, int extraId, uint16_t* remap);
+
+/**
+ * Gets the real id of a compact id
+ */
+static inline int s4354198_idmap_real(IdMap* map, uint16_t compact) {
+    return map->toReal[compact];
+}
+
+#endif
\ No newline at end of file
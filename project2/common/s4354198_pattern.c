@@ -0,0 +1,366 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+
+#include "s4354198_pattern.h"
+
+/* Defines */
+#define PATTERN_INITIAL_COORDS 256
+// Run counts past this are taken to be corrupt rather than allocated
+#define PATTERN_MAX_RUN (1 << 24)
+
+/* Function prototypes */
+static char* read_file(const char* path);
+static bool is_life_106(const char* text);
+static Pattern* parse_rle(char* text, const char** error);
+static Pattern* parse_life_106(char* text, const char** error);
+static void set_run(Pattern* pattern, int y, int x, int length);
+
+/**
+ * Creates a pattern with no live cells, or NULL if it is empty or too big
+ */
+Pattern* s4354198_pattern_create(int width, int height) {
+    // Either side past the byte limit in bits is too big, checked before
+    // rounding up to words so the sum cannot overflow
+    if (width < 1 || height < 1 || (uint64_t) width > PATTERN_MAX_BYTES * 8ULL || 
+            (uint64_t) height > PATTERN_MAX_BYTES * 8ULL) {
+        return NULL;
+    }
+
+    int words = (width + PATTERN_WORD_BITS - 1) / PATTERN_WORD_BITS;
+    if ((uint64_t) words * height * sizeof(uint64_t) > PATTERN_MAX_BYTES) {
+        return NULL;
+    }
+
+    Pattern* pattern = (Pattern*) malloc(sizeof(Pattern));
+    pattern->width = width;
+    pattern->height = height;
+    pattern->words = words;
+    pattern->bits = (uint64_t*) calloc((size_t) words * height, sizeof(uint64_t));
+
+    return pattern;
+}
+
+/**
+ * Creates a pattern no more than 64 cells wide from one word per row
+ */
+Pattern* s4354198_pattern_from_rows(int width, int height, const uint64_t* rows) {
+    Pattern* pattern = s4354198_pattern_create(width, height);
+
+    memcpy(pattern->bits, rows, sizeof(uint64_t) * height);
+
+    return pattern;
+}
+
+/**
+ * Creates a pattern from a rectangle of another, which must lie within it
+ */
+Pattern* s4354198_pattern_crop(Pattern* pattern, int left, int top, int width, int height) {
+    Pattern* cropped = s4354198_pattern_create(width, height);
+
+    for (int y = 0; y < height; y++) {
+        uint64_t* row = s4354198_pattern_row(cropped, y);
+
+        for (int word = 0; word < cropped->words; word++) {
+            row[word] = s4354198_pattern_bits(pattern, top + y, left + word * PATTERN_WORD_BITS);
+        }
+
+        // Cells past the right edge of the rectangle stay dead
+        if (width % PATTERN_WORD_BITS != 0) {
+            row[cropped->words - 1] &= (1ULL << (width % PATTERN_WORD_BITS)) - 1;
+        }
+    }
+
+    return cropped;
+}
+
+/**
+ * Frees a pattern
+ */
+void s4354198_pattern_free(Pattern* pattern) {
+    if (pattern == NULL) {
+        return;
+    }
+
+    free(pattern->bits);
+    free(pattern);
+}
+
+/**
+ * Loads an RLE or Life 1.06 pattern file. Returns NULL with error set to 
+ * the reason if it cannot be read.
+ */
+Pattern* s4354198_pattern_load(const char* path, const char** error) {
+    char* text = read_file(path);
+    Pattern* pattern;
+
+    if (text == NULL) {
+        *error = strerror(errno);
+        return NULL;
+    }
+
+    if (is_life_106(text)) {
+        pattern = parse_life_106(text, error);
+    } else {
+        pattern = parse_rle(text, error);
+    }
+
+    free(text);
+
+    return pattern;
+}
+
+/**
+ * Counts the live cells of a pattern
+ */
+long s4354198_pattern_count(Pattern* pattern) {
+    size_t words = (size_t) pattern->words * pattern->height;
+    long count = 0;
+
+    for (size_t i = 0; i < words; i++) {
+        count += __builtin_popcountll(pattern->bits[i]);
+    }
+
+    return count;
+}
+
+/**
+ * Gets the 64 cells of a row starting at a column, which may be off either
+ * side of the pattern. Cells off the pattern are dead.
+ */
+uint64_t s4354198_pattern_bits(Pattern* pattern, int y, int start) {
+    uint64_t* row = s4354198_pattern_row(pattern, y);
+    // Rounded down, so negative columns land in the word before
+    int word = (start >= 0) ? start / PATTERN_WORD_BITS : 
+        -((-start + PATTERN_WORD_BITS - 1) / PATTERN_WORD_BITS);
+    int offset = start - word * PATTERN_WORD_BITS;
+
+    uint64_t low = (word >= 0 && word < pattern->words) ? row[word] : 0;
+    uint64_t high = (word + 1 >= 0 && word + 1 < pattern->words) ? row[word + 1] : 0;
+
+    if (offset == 0) {
+        return low;
+    }
+
+    return (low >> offset) | (high << (PATTERN_WORD_BITS - offset));
+}
+
+/**
+ * Reads a whole file into a null terminated string
+ */
+static char* read_file(const char* path) {
+    FILE* file = fopen(path, "r");
+    size_t size = 0;
+    size_t capacity = BUFSIZ;
+    size_t read;
+
+    if (file == NULL) {
+        return NULL;
+    }
+
+    char* text = (char*) malloc(capacity + 1);
+    while ((read = fread(text + size, 1, capacity - size, file)) > 0) {
+        size += read;
+
+        if (size == capacity) {
+            capacity *= 2;
+            text = (char*) realloc(text, capacity + 1);
+        }
+    }
+    text[size] = '\0';
+
+    if (ferror(file)) {
+        int error = errno;
+        fclose(file);
+        free(text);
+        errno = error;
+        return NULL;
+    }
+
+    fclose(file);
+
+    return text;
+}
+
+/**
+ * Checks if a file starts with the Life 1.06 header
+ */
+static bool is_life_106(const char* text) {
+    while (isspace((unsigned char) *text)) {
+        text++;
+    }
+
+    return strncmp(text, PATTERN_LIFE_106, strlen(PATTERN_LIFE_106)) == 0;
+}
+
+/**
+ * Parses run length encoded cells, sized by the "x = m, y = n" line that 
+ * comes after any # comment lines. Any letter but b is a live cell, so 
+ * patterns with more than two states are read as plain live and dead.
+ */
+static Pattern* parse_rle(char* text, const char** error) {
+    Pattern* pattern = NULL;
+    char* line;
+    int width = 0;
+    int height = 0;
+
+    while ((line = strsep(&text, "\n")) != NULL) {
+        while (isspace((unsigned char) *line)) {
+            line++;
+        }
+
+        if (*line == '\0' || *line == '#') {
+            continue;
+        }
+
+        if (sscanf(line, "x = %d , y = %d", &width, &height) != 2) {
+            *error = "not an RLE or Life 1.06 pattern";
+            return NULL;
+        }
+        break;
+    }
+
+    if (line == NULL) {
+        *error = "the pattern has no size line";
+        return NULL;
+    }
+
+    pattern = s4354198_pattern_create(width, height);
+    if (pattern == NULL) {
+        *error = "the pattern is empty or too big";
+        return NULL;
+    }
+
+    int x = 0;
+    int y = 0;
+    int count = 0;
+
+    for (char* cursor = text; cursor != NULL && *cursor != '\0' && *cursor != '!'; cursor++) {
+        char chr = *cursor;
+        int run = (count == 0) ? 1 : count;
+
+        if (isdigit((unsigned char) chr)) {
+            count = count * 10 + (chr - '0');
+            if (count > PATTERN_MAX_RUN) {
+                *error = "a run is too long";
+                s4354198_pattern_free(pattern);
+                return NULL;
+            }
+            continue;
+        } else if (isspace((unsigned char) chr)) {
+            continue;
+        } else if (chr == '$') {
+            // Kept from running on past the pattern, so it cannot overflow
+            y = (y + run > height) ? height : y + run;
+            x = 0;
+        } else if (chr == 'b' || chr == '.') {
+            x = (x + run > width) ? width + 1 : x + run;
+        } else if (isalpha((unsigned char) chr)) {
+            if (x + run > width || y >= height) {
+                *error = "cells lie outside the size line";
+                s4354198_pattern_free(pattern);
+                return NULL;
+            }
+            set_run(pattern, y, x, run);
+            x += run;
+        } else {
+            *error = "the cells are corrupt";
+            s4354198_pattern_free(pattern);
+            return NULL;
+        }
+
+        count = 0;
+    }
+
+    return pattern;
+}
+
+/**
+ * Parses a list of "x y" live cells, which may be negative. The pattern is
+ * just big enough to hold them.
+ */
+static Pattern* parse_life_106(char* text, const char** error) {
+    int capacity = PATTERN_INITIAL_COORDS;
+    int count = 0;
+    int* coords = (int*) malloc(sizeof(int) * 2 * capacity);
+    int minX = INT_MAX;
+    int minY = INT_MAX;
+    int maxX = INT_MIN;
+    int maxY = INT_MIN;
+    char* line;
+
+    while ((line = strsep(&text, "\n")) != NULL) {
+        int x;
+        int y;
+
+        while (isspace((unsigned char) *line)) {
+            line++;
+        }
+
+        if (*line == '\0' || *line == '#') {
+            continue;
+        }
+
+        if (sscanf(line, "%d %d", &x, &y) != 2) {
+            *error = "the cells are corrupt";
+            free(coords);
+            return NULL;
+        }
+
+        if (count == capacity) {
+            capacity *= 2;
+            coords = (int*) realloc(coords, sizeof(int) * 2 * capacity);
+        }
+        coords[2 * count] = x;
+        coords[2 * count + 1] = y;
+        count++;
+
+        minX = (x < minX) ? x : minX;
+        minY = (y < minY) ? y : minY;
+        maxX = (x > maxX) ? x : maxX;
+        maxY = (y > maxY) ? y : maxY;
+    }
+
+    Pattern* pattern = NULL;
+    if (count > 0 && (int64_t) maxX - minX < INT_MAX && (int64_t) maxY - minY < INT_MAX) {
+        pattern = s4354198_pattern_create(maxX - minX + 1, maxY - minY + 1);
+    }
+
+    if (pattern == NULL) {
+        *error = "the pattern is empty or too big";
+        free(coords);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        set_run(pattern, coords[2 * i + 1] - minY, coords[2 * i] - minX, 1);
+    }
+
+    free(coords);
+
+    return pattern;
+}
+
+/**
+ * Brings a run of cells in a row to life a word at a time
+ */
+static void set_run(Pattern* pattern, int y, int x, int length) {
+    uint64_t* row = s4354198_pattern_row(pattern, y);
+
+    while (length > 0) {
+        int offset = x % PATTERN_WORD_BITS;
+        int bits = PATTERN_WORD_BITS - offset;
+        bits = (bits < length) ? bits : length;
+
+        uint64_t mask = (bits == PATTERN_WORD_BITS) ? ~0ULL : ((1ULL << bits) - 1);
+        row[x / PATTERN_WORD_BITS] |= mask << offset;
+
+        x += bits;
+        length -= bits;
+    }
+}
\ No newline at end of file
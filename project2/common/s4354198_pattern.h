@@ -0,0 +1,49 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Defines */
+#define PATTERN_WORD_BITS 64
+// Largest pattern accepted, in bytes of its packed rows
+#define PATTERN_MAX_BYTES (64 << 20)
+#define PATTERN_LIFE_106 "#Life 1.06"
+
+/*
+ * A rectangle of cells packed 64 to a word, bit n of a word being the
+ * cell n columns further right. Rows follow each other with no padding
+ * beyond rounding up to whole words, so the rows can be sent as they are.
+ */
+typedef struct {
+    int width;
+    int height;
+    int words;
+    uint64_t* bits;
+} Pattern;
+
+/* Function prototypes */
+Pattern* s4354198_pattern_create(int width, int height);
+Pattern* s4354198_pattern_from_rows(int width, int height, const uint64_t* rows);
+Pattern* s4354198_pattern_crop(Pattern* pattern, int left, int top, int width, int height);
+void s4354198_pattern_free(Pattern* pattern);
+Pattern* s4354198_pattern_load(const char* path, const char** error);
+long s4354198_pattern_count(Pattern* pattern);
+uint64_t s4354198_pattern_bits(Pattern* pattern, int y, int start);
+
+/**
+ * Gets the first word of a row
+ */
+static inline uint64_t* s4354198_pattern_row(Pattern* pattern, int y) {
+    return pattern->bits + (size_t) y * pattern->words;
+}
+
+/**
+ * Gets the size of the packed rows in bytes
+ */
+static inline size_t s4354198_pattern_bytes(Pattern* pattern) {
+    return sizeof(uint64_t) * pattern->words * (size_t) pattern->height;
+}
+
+#endif
\ No newline at end of file
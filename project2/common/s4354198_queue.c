@@ -0,0 +1,101 @@
+#include <stdlib.h>
+
+#include "s4354198_queue.h"
+
+/* Function prototypes */
+static QueueNode* skip_stub(Queue* queue, QueueNode* node);
+
+/**
+ * Creates an empty queue
+ */
+Queue* s4354198_queue_create(void) {
+    Queue* queue;
+
+    if (posix_memalign((void**) &queue, QUEUE_ALIGN, sizeof(Queue)) != 0) {
+        return NULL;
+    }
+
+    queue->stub.next = NULL;
+    queue->head = &(queue->stub);
+    queue->tail = &(queue->stub);
+
+    return queue;
+}
+
+/**
+ * Adds a node to the queue. Safe to call from any thread.
+ */
+void s4354198_queue_push(Queue* queue, QueueNode* node) {
+    __atomic_store_n(&(node->next), NULL, __ATOMIC_RELAXED);
+
+    QueueNode* previous = __atomic_exchange_n(&(queue->head), node, __ATOMIC_ACQ_REL);
+
+    // Until this store the consumer sees the queue end at the previous node
+    __atomic_store_n(&(previous->next), node, __ATOMIC_RELEASE);
+}
+
+/**
+ * Takes the oldest node off the queue, or NULL if there is none. A node 
+ * whose producer is still part way through pushing is left for the next 
+ * call. Only the consumer may call this.
+ */
+QueueNode* s4354198_queue_pop(Queue* queue) {
+    QueueNode* tail = queue->tail;
+    QueueNode* next = __atomic_load_n(&(tail->next), __ATOMIC_ACQUIRE);
+
+    if (tail == &(queue->stub)) {
+        if (next == NULL) {
+            return NULL;
+        }
+
+        queue->tail = next;
+        tail = next;
+        next = __atomic_load_n(&(next->next), __ATOMIC_ACQUIRE);
+    }
+
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != __atomic_load_n(&(queue->head), __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+
+    // The tail is the last node, so the stub goes in behind it
+    s4354198_queue_push(queue, &(queue->stub));
+
+    next = __atomic_load_n(&(tail->next), __ATOMIC_ACQUIRE);
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+
+    return NULL;
+}
+
+/**
+ * Gets the oldest node without taking it off the queue. Only the consumer
+ * may walk the queue.
+ */
+QueueNode* s4354198_queue_first(Queue* queue) {
+    return skip_stub(queue, queue->tail);
+}
+
+/**
+ * Gets the node queued after the given one
+ */
+QueueNode* s4354198_queue_next(Queue* queue, QueueNode* node) {
+    return skip_stub(queue, __atomic_load_n(&(node->next), __ATOMIC_ACQUIRE));
+}
+
+/**
+ * Steps over the stub, which is never handed out
+ */
+static QueueNode* skip_stub(Queue* queue, QueueNode* node) {
+    if (node == &(queue->stub)) {
+        return __atomic_load_n(&(node->next), __ATOMIC_ACQUIRE);
+    }
+
+    return node;
+}
\ No newline at end of file
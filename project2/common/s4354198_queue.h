@@ -0,0 +1,43 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <stdbool.h>
+
+/* Defines */
+#define QUEUE_ALIGN 64
+
+/*
+ * Link embedded as the first member of anything that is queued
+ */
+typedef struct QueueNode QueueNode;
+struct QueueNode {
+    QueueNode* next;
+};
+
+/*
+ * Intrusive lock free queue with any number of producers and a single 
+ * consumer. Producers swap themselves in at the head and then link the old
+ * head to themselves, the consumer walks from the tail. The stub node keeps
+ * the queue from ever being truly empty, so neither end needs a lock.
+ */
+typedef struct {
+    QueueNode* head __attribute__((aligned(QUEUE_ALIGN)));
+    QueueNode* tail __attribute__((aligned(QUEUE_ALIGN)));
+    QueueNode stub;
+} Queue;
+
+/* Function prototypes */
+Queue* s4354198_queue_create(void);
+void s4354198_queue_push(Queue* queue, QueueNode* node);
+QueueNode* s4354198_queue_pop(Queue* queue);
+QueueNode* s4354198_queue_first(Queue* queue);
+QueueNode* s4354198_queue_next(Queue* queue, QueueNode* node);
+
+/**
+ * Checks if there is nothing for the consumer to take
+ */
+static inline bool s4354198_queue_empty(Queue* queue) {
+    return s4354198_queue_first(queue) == NULL;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "s4354198_rule.h"
+
+/* Function prototypes */
+static bool parse_counts(const char** cursor, uint16_t* counts);
+static int format_counts(char* buffer, char prefix, uint16_t counts);
+
+/**
+ * Compiles a rule string into rule. Both "B3/S23" (in either order and any
+ * case) and the older "23/3" survive/birth form are accepted. Returns false
+ * if the string is not a rule, or it has births with no neighbours, as a 
+ * cell born that way would have no neighbour to take its id from.
+ */
+bool s4354198_rule_parse(const char* text, Rule* rule) {
+    const char* cursor = text;
+    uint16_t birth = 0;
+    uint16_t survive = 0;
+    bool hasBirth = false;
+    bool hasSurvive = false;
+
+    if (text == NULL) {
+        return false;
+    }
+
+    if (isdigit((unsigned char) *cursor) || *cursor == '/') {
+        // Survive counts come first in the old notation
+        if (!parse_counts(&cursor, &survive) || *cursor++ != '/' ||
+                !parse_counts(&cursor, &birth) || *cursor != '\0') {
+            return false;
+        }
+    } else {
+        for (int part = 0; part < 2; part++) {
+            char letter = toupper((unsigned char) *cursor++);
+
+            if (letter == 'B' && !hasBirth) {
+                hasBirth = parse_counts(&cursor, &birth);
+            } else if (letter == 'S' && !hasSurvive) {
+                hasSurvive = parse_counts(&cursor, &survive);
+            } else {
+                return false;
+            }
+
+            if (part == 0 && *cursor++ != '/') {
+                return false;
+            }
+        }
+
+        if (!hasBirth || !hasSurvive || *cursor != '\0') {
+            return false;
+        }
+    }
+
+    if (birth & 1) {
+        return false;
+    }
+
+    rule->birth = birth;
+    rule->survive = survive;
+    for (int i = 0; i <= RULE_MAX_NEIGHBOURS; i++) {
+        rule->table[0][i] = (birth >> i) & 1;
+        rule->table[1][i] = (survive >> i) & 1;
+    }
+
+    int length = format_counts(rule->name, 'B', birth);
+    rule->name[length++] = '/';
+    format_counts(rule->name + length, 'S', survive);
+
+    return true;
+}
+
+/**
+ * Checks if the rule is plain B3/S23, which has its own kernels
+ */
+bool s4354198_rule_is_conway(const Rule* rule) {
+    return rule->birth == (1 << 3) && rule->survive == ((1 << 2) | (1 << 3));
+}
+
+/**
+ * Reads a run of neighbour counts into a bit set, stopping at the first 
+ * character that is not a count
+ */
+static bool parse_counts(const char** cursor, uint16_t* counts) {
+    *counts = 0;
+
+    while (isdigit((unsigned char) **cursor)) {
+        int count = **cursor - '0';
+
+        if (count > RULE_MAX_NEIGHBOURS) {
+            return false;
+        }
+        *counts |= 1 << count;
+        (*cursor)++;
+    }
+
+    return true;
+}
+
+/**
+ * Writes a prefix and then the counts in a bit set in ascending order.
+ * Returns the number of characters written.
+ */
+static int format_counts(char* buffer, char prefix, uint16_t counts) {
+    int length = 0;
+
+    buffer[length++] = prefix;
+    for (int i = 0; i <= RULE_MAX_NEIGHBOURS; i++) {
+        if ((counts >> i) & 1) {
+            buffer[length++] = '0' + i;
+        }
+    }
+    buffer[length] = '\0';
+
+    return length;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef RULE_H
+#define RULE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines */
+#define RULE_MAX_NEIGHBOURS 8
+#define RULE_NAME_LENGTH 24
+#define RULE_CONWAY "B3/S23"
+
+/*
+ * A Life-like rule such as B36/S23. Bit n of birth is set when a dead cell
+ * with n live neighbours is born, and bit n of survive when a live one
+ * stays alive. The table holds the same thing indexed by [alive][count]
+ * so the kernels can look the next state up without branching.
+ */
+typedef struct {
+    uint16_t birth;
+    uint16_t survive;
+    uint8_t table[2][RULE_MAX_NEIGHBOURS + 1];
+    char name[RULE_NAME_LENGTH];
+} Rule;
+
+/* Function prototypes */
+bool s4354198_rule_parse(const char* text, Rule* rule);
+bool s4354198_rule_is_conway(const Rule* rule);
+
+/**
+ * Gets whether a cell is alive next generation
+ */
+static inline bool s4354198_rule_lives(const Rule* rule, bool alive, int neighbours) {
+    return rule->table[alive][neighbours];
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,744 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "s4354198_shard.h"
+#include "s4354198_cycle.h"
+
+/* Longest run a shard sends back, as its length is only 16 bits */
+#define SHARD_MAX_RUN 0xffff
+
+/* A run of cells with the same id, as a shard sends its strip back */
+typedef struct {
+    CellId id;
+    uint16_t length;
+} ShardRun;
+
+/* The change to the live cell count of one id */
+typedef struct {
+    int id;
+    int change;
+} ShardChange;
+
+/* What a shard sends back when it is synced, followed by its changes */
+typedef struct {
+    uint64_t signature;
+    int changes;
+} ShardReport;
+
+/*
+ * A shard's own strip of the board. Ghost row -1 is filled from the shard
+ * above and ghost row rows from the shard below before every generation.
+ */
+typedef struct {
+    int width;
+    int rows;
+    Grid* oldState;
+    Grid* newState;
+    Census* census;
+    FILE* commands;
+    int coordinator;
+    int up;
+    int down;
+    // Signature of the strip, worked out again only once it has changed
+    uint64_t signature;
+    bool changed;
+    void* buffer;
+    size_t bufferBytes;
+} Strip;
+
+/* Function prototypes */
+static void run_shard(int width, int rows, int coordinator, int up, int down);
+static bool step_strip(Strip* strip);
+static bool exchange_rows(Strip* strip);
+static void reserve_ghosts(Strip* strip);
+static bool report_strip(Strip* strip);
+static bool send_strip(Strip* strip);
+static void draw_strip(Strip* strip, int y, int x, int length, int id);
+static bool queue_message(Shard* shard, int command, int a, int b, int c, int d);
+static bool flush_messages(Shard* shard);
+static bool queue_all(ShardSet* shards, int command);
+static void* reserve_buffer(void** buffer, size_t* bytes, size_t wanted);
+static void room_for_rows(int socket, size_t bytes);
+static void close_inherited(int coordinator, int up, int down);
+static bool send_all(int socket, const void* data, size_t bytes);
+static bool read_all(int socket, void* data, size_t bytes);
+
+/**
+ * Splits a board into count strips of about the same height and starts a
+ * process for each, linked to the coordinator and its neighbours by Unix 
+ * domain sockets. The rule and kernel in use are inherited. Returns NULL
+ * if the sockets or processes could not be made.
+ */
+ShardSet* s4354198_shards_create(int width, int height, int count) {
+    ShardSet* shards = (ShardSet*) malloc(sizeof(ShardSet));
+    int links[count][2];
+    int edges[count][2];
+    int made = 0;
+
+    if (shards == NULL) {
+        return NULL;
+    }
+    shards->width = width;
+    shards->height = height;
+    shards->count = count;
+    shards->signature = 0;
+    shards->buffer = NULL;
+    shards->bufferBytes = 0;
+    shards->shards = (Shard*) malloc(sizeof(Shard) * count);
+    if (shards->shards == NULL) {
+        free(shards);
+        return NULL;
+    }
+
+    // Shard i talks to the coordinator over links[i] and to shard i + 1 
+    // over edges[i]
+    for (; made < count; made++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, links[made]) != 0) {
+            break;
+        }
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, edges[made]) != 0) {
+            close(links[made][0]);
+            close(links[made][1]);
+            break;
+        }
+        room_for_rows(edges[made][0], sizeof(CellId) * width);
+        room_for_rows(edges[made][1], sizeof(CellId) * width);
+    }
+
+    int started = 0;
+    if (made == count) {
+        for (; started < count; started++) {
+            Shard* shard = &(shards->shards[started]);
+            shard->rowStart = (height * started) / count;
+            shard->rowEnd = (height * (started + 1)) / count;
+            shard->socket = links[started][0];
+            shard->pendingCount = 0;
+            shard->pid = fork();
+
+            if (shard->pid < 0) {
+                break;
+            }
+
+            if (shard->pid == 0) {
+                int up = (started > 0) ? edges[started - 1][1] : -1;
+                int down = (started < count - 1) ? edges[started][0] : -1;
+
+                // Only its own ends stay open, so a shard sees the end of
+                // the coordinator as soon as it goes
+                close_inherited(links[started][1], up, down);
+
+                run_shard(width, shard->rowEnd - shard->rowStart, links[started][1], 
+                    up, down);
+                _exit(0);
+            }
+        }
+    }
+
+    for (int i = 0; i < made; i++) {
+        close(links[i][1]);
+        close(edges[i][0]);
+        close(edges[i][1]);
+    }
+
+    if (started < count) {
+        // Those already running see their socket close and stop
+        for (int i = 0; i < made; i++) {
+            close(links[i][0]);
+        }
+        for (int i = 0; i < started; i++) {
+            waitpid(shards->shards[i].pid, NULL, 0);
+        }
+        free(shards->shards);
+        free(shards);
+        return NULL;
+    }
+
+    return shards;
+}
+
+/**
+ * Stops every shard and frees the set
+ */
+void s4354198_shards_free(ShardSet* shards) {
+    if (shards == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < shards->count; i++) {
+        close(shards->shards[i].socket);
+    }
+    for (int i = 0; i < shards->count; i++) {
+        waitpid(shards->shards[i].pid, NULL, 0);
+    }
+
+    free(shards->buffer);
+    free(shards->shards);
+    free(shards);
+}
+
+/**
+ * Gives a run of cells on one row an id. Runs are held back and sent in
+ * batches. Returns false if the shard holding the row has gone.
+ */
+bool s4354198_shards_draw(ShardSet* shards, int id, int y, int x, int length) {
+    Shard* shard = shards->shards;
+
+    while (y >= shard->rowEnd) {
+        shard++;
+    }
+
+    return queue_message(shard, SHARD_DRAW, y - shard->rowStart, x, length, id);
+}
+
+/**
+ * Starts every shard stepping a number of generations, swapping edge rows
+ * between themselves. Does not wait for them to finish, the next sync or
+ * capture does. Returns false if a shard has gone.
+ */
+bool s4354198_shards_step(ShardSet* shards, unsigned long generations) {
+    while (generations > 0) {
+        int chunk = (generations > INT32_MAX) ? INT32_MAX : (int) generations;
+
+        for (int i = 0; i < shards->count; i++) {
+            if (!queue_message(&(shards->shards[i]), SHARD_STEP, chunk, 0, 0, 0)) {
+                return false;
+            }
+        }
+        generations -= chunk;
+    }
+
+    for (int i = 0; i < shards->count; i++) {
+        if (!flush_messages(&(shards->shards[i]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Waits for every shard to finish what it was sent, adds the changes to 
+ * their live cell counts to a census slot and updates the signature of the
+ * board. Returns false if a shard has gone.
+ */
+bool s4354198_shards_sync(ShardSet* shards, Census* census, int slot) {
+    uint64_t signature = 0;
+
+    if (!queue_all(shards, SHARD_SYNC)) {
+        return false;
+    }
+
+    for (int i = 0; i < shards->count; i++) {
+        ShardReport report;
+
+        if (!read_all(shards->shards[i].socket, &report, sizeof(ShardReport))) {
+            return false;
+        }
+
+        size_t bytes = sizeof(ShardChange) * report.changes;
+        ShardChange* changes = (ShardChange*) reserve_buffer(&(shards->buffer), 
+            &(shards->bufferBytes), bytes);
+        if (changes == NULL || !read_all(shards->shards[i].socket, changes, bytes)) {
+            return false;
+        }
+
+        for (int j = 0; j < report.changes; j++) {
+            s4354198_census_add(census, slot, changes[j].id, changes[j].change);
+        }
+        signature = s4354198_cycle_mix(signature, report.signature);
+    }
+
+    shards->signature = signature;
+
+    return true;
+}
+
+/**
+ * Copies the whole board from the shards into cells, one row after 
+ * another. Returns false if a shard has gone.
+ */
+bool s4354198_shards_capture(ShardSet* shards, CellId* cells) {
+    if (!queue_all(shards, SHARD_CAPTURE)) {
+        return false;
+    }
+
+    for (int i = 0; i < shards->count; i++) {
+        Shard* shard = &(shards->shards[i]);
+        CellId* cell = cells + (size_t) shard->rowStart * shards->width;
+        int count;
+
+        if (!read_all(shard->socket, &count, sizeof(int))) {
+            return false;
+        }
+
+        size_t bytes = sizeof(ShardRun) * count;
+        ShardRun* runs = (ShardRun*) reserve_buffer(&(shards->buffer), 
+            &(shards->bufferBytes), bytes);
+        if (runs == NULL || !read_all(shard->socket, runs, bytes)) {
+            return false;
+        }
+
+        for (int j = 0; j < count; j++) {
+            for (int k = 0; k < runs[j].length; k++) {
+                *cell++ = runs[j].id;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Kills every cell on every shard. Returns false if a shard has gone.
+ */
+bool s4354198_shards_clear(ShardSet* shards) {
+    return queue_all(shards, SHARD_CLEAR);
+}
+
+/**
+ * Moves the first count ids of every shard to the ids given by remap. Any
+ * changes must have been synced first. Returns false if a shard has gone.
+ */
+bool s4354198_shards_remap(ShardSet* shards, const CellId* remap, int count) {
+    for (int i = 0; i < shards->count; i++) {
+        Shard* shard = &(shards->shards[i]);
+
+        if (!queue_message(shard, SHARD_REMAP, count, 0, 0, 0) || 
+                !flush_messages(shard) || 
+                !send_all(shard->socket, remap, sizeof(CellId) * count)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Hands a new rule to every shard. Returns false if a shard has gone.
+ */
+bool s4354198_shards_set_rule(ShardSet* shards, const Rule* rule) {
+    for (int i = 0; i < shards->count; i++) {
+        Shard* shard = &(shards->shards[i]);
+
+        if (!queue_message(shard, SHARD_RULE, 0, 0, 0, 0) || !flush_messages(shard) ||
+                !send_all(shard->socket, rule, sizeof(Rule))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Runs a shard's commands until the coordinator goes away
+ */
+static void run_shard(int width, int rows, int coordinator, int up, int down) {
+    Strip strip = {
+        .width = width,
+        .rows = rows,
+        .oldState = s4354198_grid_create(width, rows),
+        .newState = s4354198_grid_create(width, rows),
+        .census = s4354198_census_create(1),
+        .commands = fdopen(coordinator, "r"),
+        .coordinator = coordinator,
+        .up = up,
+        .down = down,
+        .signature = 0,
+        .changed = true,
+        .buffer = NULL,
+        .bufferBytes = 0
+    };
+    ShardMessage message;
+    bool running = strip.oldState != NULL && strip.newState != NULL && 
+        strip.commands != NULL;
+
+    while (running && fread(&message, sizeof(ShardMessage), 1, strip.commands) == 1) {
+        switch (message.command) {
+            case SHARD_DRAW:
+                draw_strip(&strip, message.args[0], message.args[1], message.args[2],
+                    message.args[3]);
+                break;
+            case SHARD_STEP:
+                for (int i = 0; running && i < message.args[0]; i++) {
+                    running = step_strip(&strip);
+                }
+                break;
+            case SHARD_SYNC:
+                running = report_strip(&strip);
+                break;
+            case SHARD_CAPTURE:
+                running = send_strip(&strip);
+                break;
+            case SHARD_CLEAR:
+                strip.changed = true;
+                s4354198_grid_clear(strip.oldState);
+                s4354198_grid_clear(strip.newState);
+                s4354198_census_reset(strip.census);
+                break;
+            case SHARD_REMAP: {
+                int count = message.args[0];
+                CellId* remap = (CellId*) reserve_buffer(&(strip.buffer), 
+                    &(strip.bufferBytes), sizeof(CellId) * count);
+
+                running = remap != NULL && 
+                    fread(remap, sizeof(CellId), count, strip.commands) == count;
+                if (running) {
+                    strip.changed = true;
+                    s4354198_grid_remap(strip.oldState, remap);
+                    s4354198_grid_remap(strip.newState, remap);
+                    s4354198_census_remap(strip.census, remap, count);
+                }
+                break;
+            }
+            case SHARD_RULE: {
+                Rule rule;
+
+                running = fread(&rule, sizeof(Rule), 1, strip.commands) == 1;
+                if (running) {
+                    s4354198_grid_set_rule(&rule);
+                }
+                break;
+            }
+            default:
+                running = false;
+                break;
+        }
+    }
+}
+
+/**
+ * Gives a run of cells in the strip an id, counting the cells that change
+ */
+static void draw_strip(Strip* strip, int y, int x, int length, int id) {
+    CellId* cells = &(s4354198_grid_row(strip->oldState, y)[x]);
+
+    s4354198_census_reserve(strip->census, id);
+    strip->changed = true;
+    for (int i = 0; i < length; i++) {
+        if (cells[i] != id) {
+            s4354198_census_record(strip->census, 0, cells[i], id);
+            cells[i] = id;
+        }
+    }
+}
+
+/**
+ * Computes the strip's next generation once its ghost rows are filled in
+ * from the neighbouring shards. Returns false if one of them has gone.
+ */
+static bool step_strip(Strip* strip) {
+    Grid* oldState = strip->oldState;
+    Grid* newState = strip->newState;
+
+    if (!exchange_rows(strip)) {
+        return false;
+    }
+    reserve_ghosts(strip);
+
+    for (int row = 0; row < strip->rows; row++) {
+        CellId* previous = s4354198_grid_row(oldState, row);
+        CellId* current = s4354198_grid_row(newState, row);
+
+        s4354198_grid_step_row(oldState, newState, row);
+        if (memcmp(previous, current, sizeof(CellId) * strip->width) == 0) {
+            continue;
+        }
+        strip->changed = true;
+        for (int x = 0; x < strip->width; x++) {
+            if (previous[x] != current[x]) {
+                s4354198_census_record(strip->census, 0, previous[x], current[x]);
+            }
+        }
+    }
+
+    strip->oldState = newState;
+    strip->newState = oldState;
+
+    return true;
+}
+
+/**
+ * Sends the strip's top and bottom rows to the shards above and below, 
+ * then fills its ghost rows with theirs. Everything is sent before 
+ * anything is read, and a socket holds a couple of rows, so neighbours 
+ * never wait on each other.
+ */
+static bool exchange_rows(Strip* strip) {
+    Grid* grid = strip->oldState;
+    size_t bytes = sizeof(CellId) * strip->width;
+
+    if (strip->up >= 0 && !send_all(strip->up, s4354198_grid_row(grid, 0), bytes)) {
+        return false;
+    }
+    if (strip->down >= 0 && 
+            !send_all(strip->down, s4354198_grid_row(grid, strip->rows - 1), bytes)) {
+        return false;
+    }
+    if (strip->up >= 0 && !read_all(strip->up, s4354198_grid_row(grid, -1), bytes)) {
+        return false;
+    }
+    if (strip->down >= 0 && 
+            !read_all(strip->down, s4354198_grid_row(grid, strip->rows), bytes)) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Makes room in the census for every id in the ghost rows. Ids drawn on
+ * other shards can only get into the strip through them.
+ */
+static void reserve_ghosts(Strip* strip) {
+    CellId* above = s4354198_grid_row(strip->oldState, -1);
+    CellId* below = s4354198_grid_row(strip->oldState, strip->rows);
+    CellId highest = 0;
+
+    for (int x = 0; x < strip->width; x++) {
+        highest = (above[x] > highest) ? above[x] : highest;
+        highest = (below[x] > highest) ? below[x] : highest;
+    }
+
+    s4354198_census_reserve(strip->census, highest);
+}
+
+/**
+ * Sends the coordinator the signature of the strip and every change to 
+ * its live cell counts since the last report
+ */
+static bool report_strip(Strip* strip) {
+    CensusDelta* delta = &(strip->census->deltas[0]);
+    ShardReport report = {.signature = strip->signature, .changes = 0};
+    ShardChange* changes = (ShardChange*) reserve_buffer(&(strip->buffer), 
+        &(strip->bufferBytes), sizeof(ShardChange) * (delta->touchedCount + 1));
+
+    if (changes == NULL) {
+        return false;
+    }
+
+    if (strip->changed) {
+        report.signature = 0;
+        for (int row = 0; row < strip->rows; row++) {
+            report.signature = s4354198_cycle_mix_cells(report.signature, 
+                s4354198_grid_row(strip->oldState, row), strip->width);
+        }
+        strip->signature = report.signature;
+        strip->changed = false;
+    }
+
+    // Each change is cleared as it is sent, as only the coordinator keeps
+    // counts
+    for (int i = 0; i < delta->touchedCount; i++) {
+        int id = delta->touched[i];
+
+        delta->listed[id] = false;
+        if (delta->deltas[id] != 0) {
+            changes[report.changes].id = id;
+            changes[report.changes].change = delta->deltas[id];
+            report.changes++;
+            delta->deltas[id] = 0;
+        }
+    }
+    delta->touchedCount = 0;
+
+    return send_all(strip->coordinator, &report, sizeof(ShardReport)) &&
+        send_all(strip->coordinator, changes, sizeof(ShardChange) * report.changes);
+}
+
+/**
+ * Sends the coordinator every cell of the strip as runs, row after row
+ */
+static bool send_strip(Strip* strip) {
+    // There is at most one run per cell
+    size_t most = (size_t) strip->width * strip->rows;
+    ShardRun* runs = (ShardRun*) reserve_buffer(&(strip->buffer), &(strip->bufferBytes),
+        sizeof(ShardRun) * most);
+    int count = 0;
+
+    if (runs == NULL) {
+        return false;
+    }
+
+    for (int row = 0; row < strip->rows; row++) {
+        CellId* cells = s4354198_grid_row(strip->oldState, row);
+
+        for (int x = 0; x < strip->width; x++) {
+            if (count > 0 && runs[count - 1].id == cells[x] && 
+                    runs[count - 1].length < SHARD_MAX_RUN) {
+                runs[count - 1].length++;
+            } else {
+                runs[count].id = cells[x];
+                runs[count].length = 1;
+                count++;
+            }
+        }
+    }
+
+    return send_all(strip->coordinator, &count, sizeof(int)) &&
+        send_all(strip->coordinator, runs, sizeof(ShardRun) * count);
+}
+
+/**
+ * Adds a message to those waiting to go to a shard, sending them if there
+ * is no room. Returns false if the shard has gone.
+ */
+static bool queue_message(Shard* shard, int command, int a, int b, int c, int d) {
+    if (shard->pendingCount == SHARD_BATCH && !flush_messages(shard)) {
+        return false;
+    }
+
+    ShardMessage* message = &(shard->pending[shard->pendingCount++]);
+    message->command = command;
+    message->args[0] = a;
+    message->args[1] = b;
+    message->args[2] = c;
+    message->args[3] = d;
+
+    return true;
+}
+
+/**
+ * Sends every waiting message to a shard. Returns false if it has gone.
+ */
+static bool flush_messages(Shard* shard) {
+    int count = shard->pendingCount;
+
+    shard->pendingCount = 0;
+
+    return send_all(shard->socket, shard->pending, sizeof(ShardMessage) * count);
+}
+
+/**
+ * Sends the same command with no arguments to every shard
+ */
+static bool queue_all(ShardSet* shards, int command) {
+    for (int i = 0; i < shards->count; i++) {
+        Shard* shard = &(shards->shards[i]);
+
+        if (!queue_message(shard, command, 0, 0, 0, 0) || !flush_messages(shard)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Grows a buffer to hold at least some bytes. Returns NULL if there is not
+ * the memory.
+ */
+static void* reserve_buffer(void** buffer, size_t* bytes, size_t wanted) {
+    // Never left empty, so NULL always means there was not the memory
+    if (*buffer == NULL || wanted > *bytes) {
+        size_t size = (wanted > 0) ? wanted : 1;
+        void* grown = realloc(*buffer, size);
+
+        if (grown == NULL) {
+            return NULL;
+        }
+        *buffer = grown;
+        *bytes = size;
+    }
+
+    return *buffer;
+}
+
+/**
+ * Makes sure a socket can hold a few rows of cells without its reader,
+ * so a shard can send both its edges before reading either
+ */
+static void room_for_rows(int socket, size_t bytes) {
+    int size;
+    socklen_t length = sizeof(size);
+
+    if (getsockopt(socket, SOL_SOCKET, SO_SNDBUF, &size, &length) == 0 && 
+            (size_t) size < 4 * bytes) {
+        size = (int) (4 * bytes);
+        setsockopt(socket, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    }
+}
+
+/**
+ * Closes every descriptor a shard inherited but its own three sockets and
+ * the standard streams, from cag's FIFOs to the ends other shards hold
+ */
+static void close_inherited(int coordinator, int up, int down) {
+    DIR* dir = opendir("/proc/self/fd");
+
+    if (dir == NULL) {
+        long limit = sysconf(_SC_OPEN_MAX);
+
+        for (int fd = STDERR_FILENO + 1; fd < limit; fd++) {
+            if (fd != coordinator && fd != up && fd != down) {
+                close(fd);
+            }
+        }
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        int fd = atoi(entry->d_name);
+
+        if (fd > STDERR_FILENO && fd != dirfd(dir) && fd != coordinator && 
+                fd != up && fd != down) {
+            close(fd);
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * Writes every byte to a socket, without being killed if the other end has
+ * gone. Returns false if it has.
+ */
+static bool send_all(int socket, const void* data, size_t bytes) {
+    const char* next = (const char*) data;
+
+    while (bytes > 0) {
+        ssize_t sent = send(socket, next, bytes, MSG_NOSIGNAL);
+
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        next += sent;
+        bytes -= sent;
+    }
+
+    return true;
+}
+
+/**
+ * Reads exactly some bytes from a socket. Returns false if the other end 
+ * has gone first.
+ */
+static bool read_all(int socket, void* data, size_t bytes) {
+    char* next = (char*) data;
+
+    while (bytes > 0) {
+        ssize_t got = read(socket, next, bytes);
+
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        next += got;
+        bytes -= got;
+    }
+
+    return true;
+}
\ No newline at end of file
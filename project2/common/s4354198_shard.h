@@ -0,0 +1,76 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "s4354198_grid.h"
+#include "s4354198_census.h"
+#include "s4354198_rule.h"
+
+/* Defines */
+// Messages held back before they are sent to a shard in one go
+#define SHARD_BATCH 256
+
+/* What a shard is asked to do */
+typedef enum {
+    SHARD_DRAW,
+    SHARD_STEP,
+    SHARD_SYNC,
+    SHARD_CAPTURE,
+    SHARD_CLEAR,
+    SHARD_REMAP,
+    SHARD_RULE
+} ShardCommand;
+
+/* A command sent to a shard, with up to four arguments */
+typedef struct {
+    int command;
+    int args[4];
+} ShardMessage;
+
+/*
+ * One process owning a horizontal strip of the board, seen from the 
+ * coordinator
+ */
+typedef struct {
+    pid_t pid;
+    int socket;
+    int rowStart;
+    int rowEnd;
+    ShardMessage pending[SHARD_BATCH];
+    int pendingCount;
+} Shard;
+
+/*
+ * A board split into strips across several processes. Each shard steps 
+ * its own strip and swaps its edge rows with the shards above and below 
+ * every generation, so the coordinator only sends commands and gathers 
+ * counts, signatures and frames.
+ */
+typedef struct {
+    int width;
+    int height;
+    int count;
+    Shard* shards;
+    // Signature of the whole board when the shards were last synced
+    uint64_t signature;
+    // Replies from the shards are read into here
+    void* buffer;
+    size_t bufferBytes;
+} ShardSet;
+
+/* Function prototypes */
+ShardSet* s4354198_shards_create(int width, int height, int count);
+void s4354198_shards_free(ShardSet* shards);
+bool s4354198_shards_draw(ShardSet* shards, int id, int y, int x, int length);
+bool s4354198_shards_step(ShardSet* shards, unsigned long generations);
+bool s4354198_shards_sync(ShardSet* shards, Census* census, int slot);
+bool s4354198_shards_capture(ShardSet* shards, CellId* cells);
+bool s4354198_shards_clear(ShardSet* shards);
+bool s4354198_shards_remap(ShardSet* shards, const CellId* remap, int count);
+bool s4354198_shards_set_rule(ShardSet* shards, const Rule* rule);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "s4354198_snapshot.h"
+
+/**
+ * Creates an empty snapshot of a board of the given size. Returns NULL if
+ * the cells cannot be allocated.
+ */
+Snapshot* s4354198_snapshot_create(int width, int height) {
+    Snapshot* snapshot = (Snapshot*) malloc(sizeof(Snapshot));
+    snapshot->width = width;
+    snapshot->height = height;
+    snapshot->cells = (CellId*) calloc((size_t) width * height, sizeof(CellId));
+    if (snapshot->cells == NULL) {
+        free(snapshot);
+        return NULL;
+    }
+
+    snapshot->idCapacity = 64;
+    snapshot->toReal = (int*) malloc(sizeof(int) * snapshot->idCapacity);
+    snapshot->toReal[0] = 0;
+    snapshot->idCount = 1;
+    snapshot->line = NULL;
+    snapshot->lineCapacity = 0;
+    snapshot->hasLine = false;
+    snapshot->tick = 0;
+
+    return snapshot;
+}
+
+/**
+ * Frees a snapshot
+ */
+void s4354198_snapshot_free(Snapshot* snapshot) {
+    free(snapshot->cells);
+    free(snapshot->toReal);
+    free(snapshot->line);
+    free(snapshot);
+}
+
+/**
+ * Copies the real id of every compact id used by the cells
+ */
+void s4354198_snapshot_set_ids(Snapshot* snapshot, const int* toReal, int count) {
+    if (count > snapshot->idCapacity) {
+        while (count > snapshot->idCapacity) {
+            snapshot->idCapacity *= 2;
+        }
+        snapshot->toReal = (int*) realloc(snapshot->toReal, 
+            sizeof(int) * snapshot->idCapacity);
+    }
+
+    memcpy(snapshot->toReal, toReal, sizeof(int) * count);
+    snapshot->idCount = count;
+    snapshot->hasLine = false;
+}
+
+/**
+ * Makes the snapshot hold a finished line rather than cells
+ */
+void s4354198_snapshot_set_line(Snapshot* snapshot, const char* line) {
+    size_t bytes = strlen(line) + 1;
+
+    if (bytes > snapshot->lineCapacity) {
+        snapshot->lineCapacity = bytes;
+        snapshot->line = (char*) realloc(snapshot->line, snapshot->lineCapacity);
+    }
+
+    memcpy(snapshot->line, line, bytes);
+    snapshot->hasLine = true;
+}
+
+/**
+ * Builds the frame of a snapshot of cells, joining runs of the same id
+ */
+void s4354198_snapshot_write(Snapshot* snapshot, FrameWriter* frame) {
+    s4354198_frame_writer_reset(frame);
+
+    for (int y = 0; y < snapshot->height; y++) {
+        CellId* row = s4354198_snapshot_row(snapshot, y);
+        int x = 0;
+
+        while (x < snapshot->width) {
+            int start = x;
+
+            while (x < snapshot->width && row[x] == row[start]) {
+                x++;
+            }
+
+            s4354198_frame_writer_push(frame, snapshot->toReal[row[start]], x - start);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "s4354198_grid.h"
+#include "s4354198_frame.h"
+
+/*
+ * The visible board as it was at the end of a tick, so its frame can be 
+ * built and written while the next generation is computed. Cells hold 
+ * compact ids, read through a copy of the id map taken at the same time.
+ * A snapshot can hold a finished line instead, for frames that are only
+ * being replayed.
+ */
+typedef struct {
+    int width;
+    int height;
+    CellId* cells;
+    int* toReal;
+    int idCount;
+    int idCapacity;
+    char* line;
+    size_t lineCapacity;
+    bool hasLine;
+    // Cycle tick the frame belongs to
+    unsigned long tick;
+} Snapshot;
+
+/* Function prototypes */
+Snapshot* s4354198_snapshot_create(int width, int height);
+void s4354198_snapshot_free(Snapshot* snapshot);
+void s4354198_snapshot_set_ids(Snapshot* snapshot, const int* toReal, int count);
+void s4354198_snapshot_set_line(Snapshot* snapshot, const char* line);
+void s4354198_snapshot_write(Snapshot* snapshot, FrameWriter* frame);
+
+/**
+ * Gets the cells of one row of the snapshot
+ */
+static inline CellId* s4354198_snapshot_row(Snapshot* snapshot, int y) {
+    return snapshot->cells + (size_t) y * snapshot->width;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,509 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "s4354198_sparse.h"
+#include "s4354198_cycle.h"
+
+/* Function prototypes */
+static int hash_tile(int tileX, int tileY, int bucketCount);
+static void grow_buckets(SparseWorld* world);
+static SparseTile* new_tile(SparseWorld* world, int tileX, int tileY);
+static void free_tile(SparseWorld* world, SparseTile* tile);
+static bool wanted(SparseWorld* world, SparseTile* tile);
+static unsigned char edge_bits(int x, int y);
+
+/* Globals */
+// Tile offsets of each neighbour direction
+static const int offsetX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+static const int offsetY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+/**
+ * Creates an empty universe
+ */
+SparseWorld* s4354198_sparse_create(void) {
+    SparseWorld* world = (SparseWorld*) malloc(sizeof(SparseWorld));
+    world->bucketCount = SPARSE_INITIAL_BUCKETS;
+    world->buckets = (SparseTile**) calloc(world->bucketCount, sizeof(SparseTile*));
+    world->tileCapacity = SPARSE_INITIAL_BUCKETS;
+    world->tiles = (SparseTile**) malloc(sizeof(SparseTile*) * world->tileCapacity);
+    world->tileCount = 0;
+    world->freeTiles = NULL;
+    world->current = 0;
+
+    return world;
+}
+
+/**
+ * Frees every tile, keeping them around for reuse
+ */
+void s4354198_sparse_clear(SparseWorld* world) {
+    while (world->tileCount > 0) {
+        free_tile(world, world->tiles[world->tileCount - 1]);
+    }
+}
+
+/**
+ * Finds the tile at the given tile coordinates, or NULL if there is none
+ */
+SparseTile* s4354198_sparse_find(SparseWorld* world, int tileX, int tileY) {
+    SparseTile* tile = world->buckets[hash_tile(tileX, tileY, world->bucketCount)];
+
+    while (tile != NULL && (tile->tileX != tileX || tile->tileY != tileY)) {
+        tile = tile->next;
+    }
+
+    return tile;
+}
+
+/**
+ * Gets the current id of a cell
+ */
+CellId s4354198_sparse_get(SparseWorld* world, int x, int y) {
+    int tileX = s4354198_sparse_floor_div(x, SPARSE_TILE_SIDE);
+    int tileY = s4354198_sparse_floor_div(y, SPARSE_TILE_SIDE);
+    SparseTile* tile = s4354198_sparse_find(world, tileX, tileY);
+
+    if (tile == NULL) {
+        return 0;
+    }
+
+    return s4354198_grid_row(tile->grids[world->current], 
+        y - tileY * SPARSE_TILE_SIDE)[x - tileX * SPARSE_TILE_SIDE];
+}
+
+/**
+ * Sets the current id of a cell, allocating its tile if needed. Returns
+ * the id the cell had before.
+ */
+CellId s4354198_sparse_set(SparseWorld* world, int x, int y, CellId id) {
+    int tileX = s4354198_sparse_floor_div(x, SPARSE_TILE_SIDE);
+    int tileY = s4354198_sparse_floor_div(y, SPARSE_TILE_SIDE);
+    SparseTile* tile = s4354198_sparse_find(world, tileX, tileY);
+
+    if (tile == NULL) {
+        if (id == 0) {
+            return 0;
+        }
+        tile = new_tile(world, tileX, tileY);
+    }
+
+    int localX = x - tileX * SPARSE_TILE_SIDE;
+    int localY = y - tileY * SPARSE_TILE_SIDE;
+    CellId* cell = &(s4354198_grid_row(tile->grids[world->current], localY)[localX]);
+    CellId previous = *cell;
+
+    // Killing a cell leaves the flags as they were, which is only ever 
+    // more work rather than wrong
+    *cell = id;
+    if (id != 0) {
+        tile->alive[world->current] = true;
+        tile->edges[world->current] |= edge_bits(localX, localY);
+    }
+
+    return previous;
+}
+
+/**
+ * Gives a run of cells along a row the same id, looking each tile up only
+ * once. The ids the cells had before are written to previous.
+ */
+void s4354198_sparse_set_run(SparseWorld* world, int x, int y, int length, CellId id, 
+        CellId* previous) {
+    int tileY = s4354198_sparse_floor_div(y, SPARSE_TILE_SIDE);
+    int localY = y - tileY * SPARSE_TILE_SIDE;
+
+    while (length > 0) {
+        int tileX = s4354198_sparse_floor_div(x, SPARSE_TILE_SIDE);
+        int localX = x - tileX * SPARSE_TILE_SIDE;
+        int count = SPARSE_TILE_SIDE - localX;
+        count = (count < length) ? count : length;
+
+        SparseTile* tile = s4354198_sparse_find(world, tileX, tileY);
+        if (tile == NULL && id != 0) {
+            tile = new_tile(world, tileX, tileY);
+        }
+
+        if (tile == NULL) {
+            memset(previous, 0, sizeof(CellId) * count);
+        } else {
+            CellId* cells = &(s4354198_grid_row(tile->grids[world->current], localY)[localX]);
+
+            memcpy(previous, cells, sizeof(CellId) * count);
+            for (int i = 0; i < count; i++) {
+                cells[i] = id;
+            }
+
+            if (id != 0) {
+                tile->alive[world->current] = true;
+                tile->edges[world->current] |= edge_bits(localX, localY) | 
+                    edge_bits(localX + count - 1, localY);
+            }
+        }
+
+        x += count;
+        length -= count;
+        previous += count;
+    }
+}
+
+/**
+ * Allocates the neighbours that live cells on the edge of a tile could 
+ * give birth into next generation
+ */
+void s4354198_sparse_expand(SparseWorld* world) {
+    int count = world->tileCount;
+
+    for (int i = 0; i < count; i++) {
+        for (int d = 0; d < 8; d++) {
+            SparseTile* tile = world->tiles[i];
+
+            if ((tile->edges[world->current] & (1 << d)) && tile->neighbours[d] == NULL) {
+                new_tile(world, tile->tileX + offsetX[d], tile->tileY + offsetY[d]);
+            }
+        }
+    }
+}
+
+/**
+ * Copies the cells bordering a tile into the ghost cells of its current
+ * grid. Only the tile's own ghosts are written, so tiles can be filled 
+ * in parallel.
+ */
+void s4354198_sparse_fill_halo(SparseWorld* world, SparseTile* tile) {
+    int side = SPARSE_TILE_SIDE;
+    int current = world->current;
+    Grid* grid = tile->grids[current];
+    SparseTile** around = tile->neighbours;
+    CellId* above = s4354198_grid_row(grid, -1);
+    CellId* below = s4354198_grid_row(grid, side);
+
+    if (around[SPARSE_N] != NULL) {
+        memcpy(above, s4354198_grid_row(around[SPARSE_N]->grids[current], side - 1), 
+            sizeof(CellId) * side);
+    } else {
+        memset(above, 0, sizeof(CellId) * side);
+    }
+
+    if (around[SPARSE_S] != NULL) {
+        memcpy(below, s4354198_grid_row(around[SPARSE_S]->grids[current], 0), 
+            sizeof(CellId) * side);
+    } else {
+        memset(below, 0, sizeof(CellId) * side);
+    }
+
+    for (int y = 0; y < side; y++) {
+        CellId* row = s4354198_grid_row(grid, y);
+
+        row[-1] = (around[SPARSE_W] == NULL) ? 0 : 
+            s4354198_grid_row(around[SPARSE_W]->grids[current], y)[side - 1];
+        row[side] = (around[SPARSE_E] == NULL) ? 0 : 
+            s4354198_grid_row(around[SPARSE_E]->grids[current], y)[0];
+    }
+
+    above[-1] = (around[SPARSE_NW] == NULL) ? 0 : 
+        s4354198_grid_row(around[SPARSE_NW]->grids[current], side - 1)[side - 1];
+    above[side] = (around[SPARSE_NE] == NULL) ? 0 : 
+        s4354198_grid_row(around[SPARSE_NE]->grids[current], side - 1)[0];
+    below[-1] = (around[SPARSE_SW] == NULL) ? 0 : 
+        s4354198_grid_row(around[SPARSE_SW]->grids[current], 0)[side - 1];
+    below[side] = (around[SPARSE_SE] == NULL) ? 0 : 
+        s4354198_grid_row(around[SPARSE_SE]->grids[current], 0)[0];
+}
+
+/**
+ * Works out the flags of one of a tile's grids from its cells
+ */
+void s4354198_sparse_scan(SparseTile* tile, int which) {
+    Grid* grid = tile->grids[which];
+    bool alive = false;
+    unsigned char edges = 0;
+
+    for (int y = 0; y < SPARSE_TILE_SIDE; y++) {
+        CellId* row = s4354198_grid_row(grid, y);
+        bool border = (y == 0 || y == SPARSE_TILE_SIDE - 1);
+
+        for (int x = 0; x < SPARSE_TILE_SIDE; x++) {
+            if (row[x] == 0) {
+                continue;
+            }
+
+            alive = true;
+            if (border || x == 0 || x == SPARSE_TILE_SIDE - 1) {
+                edges |= edge_bits(x, y);
+            }
+        }
+    }
+
+    tile->alive[which] = alive;
+    tile->edges[which] = edges;
+}
+
+/**
+ * Combines the signatures of the tiles holding live cells. Tiles are
+ * summed as they are kept in no particular order.
+ */
+uint64_t s4354198_sparse_signature(SparseWorld* world) {
+    uint64_t signature = 0;
+
+    for (int i = 0; i < world->tileCount; i++) {
+        SparseTile* tile = world->tiles[i];
+
+        if (tile->alive[world->current]) {
+            uint64_t place = ((uint64_t) (uint32_t) tile->tileX << 32) | 
+                (uint32_t) tile->tileY;
+            signature += s4354198_cycle_mix(place, tile->signature);
+        }
+    }
+
+    return signature;
+}
+
+/**
+ * Makes the next generation the current one, then frees the tiles that
+ * have emptied and that no neighbour is about to spill into
+ */
+void s4354198_sparse_flip(SparseWorld* world) {
+    world->current = 1 - world->current;
+
+    for (int i = world->tileCount - 1; i >= 0; i--) {
+        SparseTile* tile = world->tiles[i];
+
+        if (!tile->alive[world->current] && !wanted(world, tile)) {
+            free_tile(world, tile);
+        }
+    }
+}
+
+/**
+ * Replaces every id in the universe with remap[id]
+ */
+void s4354198_sparse_remap(SparseWorld* world, const CellId* remap) {
+    for (int i = 0; i < world->tileCount; i++) {
+        s4354198_grid_remap(world->tiles[i]->grids[0], remap);
+        s4354198_grid_remap(world->tiles[i]->grids[1], remap);
+    }
+}
+
+/**
+ * Fills the current generation of a tile from SPARSE_TILE_SIDE rows of 
+ * cells, allocating the tile if it is missing
+ */
+void s4354198_sparse_load_tile(SparseWorld* world, int tileX, int tileY, 
+        const CellId* cells) {
+    SparseTile* tile = s4354198_sparse_find(world, tileX, tileY);
+
+    if (tile == NULL) {
+        tile = new_tile(world, tileX, tileY);
+    }
+
+    for (int y = 0; y < SPARSE_TILE_SIDE; y++) {
+        memcpy(s4354198_grid_row(tile->grids[world->current], y), 
+            &cells[y * SPARSE_TILE_SIDE], sizeof(CellId) * SPARSE_TILE_SIDE);
+    }
+    s4354198_sparse_scan(tile, world->current);
+}
+
+/**
+ * Copies a window of the universe into width * height cells, row after 
+ * row. Missing and empty tiles are filled with dead cells.
+ */
+void s4354198_sparse_capture(SparseWorld* world, int left, int top, int width, 
+        int height, CellId* cells) {
+    int side = SPARSE_TILE_SIDE;
+    int firstTile = s4354198_sparse_floor_div(left, side);
+    int tilesAcross = s4354198_sparse_floor_div(left + width - 1, side) - firstTile + 1;
+    SparseTile* tiles[tilesAcross];
+
+    for (int y = top; y < top + height; y++) {
+        int tileY = s4354198_sparse_floor_div(y, side);
+        int localY = y - tileY * side;
+        CellId* out = cells + (size_t) (y - top) * width;
+
+        // Look the tiles up once per row of tiles
+        if (y == top || localY == 0) {
+            for (int k = 0; k < tilesAcross; k++) {
+                tiles[k] = s4354198_sparse_find(world, firstTile + k, tileY);
+            }
+        }
+
+        for (int k = 0; k < tilesAcross; k++) {
+            int tileLeft = (firstTile + k) * side;
+            int start = (left > tileLeft) ? left - tileLeft : 0;
+            int end = (left + width < tileLeft + side) ? left + width - tileLeft : side;
+            SparseTile* tile = tiles[k];
+            CellId* into = out + tileLeft + start - left;
+
+            if (tile == NULL || !tile->alive[world->current]) {
+                memset(into, 0, sizeof(CellId) * (end - start));
+                continue;
+            }
+
+            memcpy(into, s4354198_grid_row(tile->grids[world->current], localY) + start,
+                sizeof(CellId) * (end - start));
+        }
+    }
+}
+
+/**
+ * Hashes tile coordinates into a bucket
+ */
+static int hash_tile(int tileX, int tileY, int bucketCount) {
+    unsigned int hash = (unsigned int) tileX * 0x9E3779B1u;
+
+    hash ^= (unsigned int) tileY * 0x85EBCA77u;
+    hash ^= hash >> 15;
+
+    return (int) (hash & (unsigned int) (bucketCount - 1));
+}
+
+/**
+ * Doubles the number of hash buckets
+ */
+static void grow_buckets(SparseWorld* world) {
+    int count = world->bucketCount * 2;
+    SparseTile** buckets = (SparseTile**) calloc(count, sizeof(SparseTile*));
+
+    for (int i = 0; i < world->tileCount; i++) {
+        SparseTile* tile = world->tiles[i];
+        int bucket = hash_tile(tile->tileX, tile->tileY, count);
+
+        tile->next = buckets[bucket];
+        buckets[bucket] = tile;
+    }
+
+    free(world->buckets);
+    world->buckets = buckets;
+    world->bucketCount = count;
+}
+
+/**
+ * Adds an empty tile to the universe and links it to its neighbours
+ */
+static SparseTile* new_tile(SparseWorld* world, int tileX, int tileY) {
+    SparseTile* tile = world->freeTiles;
+
+    if (tile != NULL) {
+        world->freeTiles = tile->next;
+        s4354198_grid_clear(tile->grids[0]);
+        s4354198_grid_clear(tile->grids[1]);
+    } else {
+        tile = (SparseTile*) malloc(sizeof(SparseTile));
+        tile->grids[0] = s4354198_grid_create(SPARSE_TILE_SIDE, SPARSE_TILE_SIDE);
+        tile->grids[1] = s4354198_grid_create(SPARSE_TILE_SIDE, SPARSE_TILE_SIDE);
+    }
+
+    tile->tileX = tileX;
+    tile->tileY = tileY;
+    tile->alive[0] = false;
+    tile->alive[1] = false;
+    tile->edges[0] = 0;
+    tile->edges[1] = 0;
+    tile->signature = 0;
+
+    for (int d = 0; d < 8; d++) {
+        SparseTile* neighbour = s4354198_sparse_find(world, tileX + offsetX[d], 
+            tileY + offsetY[d]);
+
+        tile->neighbours[d] = neighbour;
+        if (neighbour != NULL) {
+            neighbour->neighbours[7 - d] = tile;
+        }
+    }
+
+    if (world->tileCount == world->tileCapacity) {
+        world->tileCapacity *= 2;
+        world->tiles = (SparseTile**) realloc(world->tiles, 
+            sizeof(SparseTile*) * world->tileCapacity);
+    }
+    tile->index = world->tileCount;
+    world->tiles[world->tileCount++] = tile;
+
+    int bucket = hash_tile(tileX, tileY, world->bucketCount);
+    tile->next = world->buckets[bucket];
+    world->buckets[bucket] = tile;
+
+    if (world->tileCount > world->bucketCount) {
+        grow_buckets(world);
+    }
+
+    return tile;
+}
+
+/**
+ * Takes a tile out of the universe and puts it on the free list
+ */
+static void free_tile(SparseWorld* world, SparseTile* tile) {
+    for (int d = 0; d < 8; d++) {
+        if (tile->neighbours[d] != NULL) {
+            tile->neighbours[d]->neighbours[7 - d] = NULL;
+        }
+    }
+
+    SparseTile** link = &(world->buckets[hash_tile(tile->tileX, tile->tileY, 
+        world->bucketCount)]);
+    while (*link != tile) {
+        link = &((*link)->next);
+    }
+    *link = tile->next;
+
+    // Fill the gap in the list with the last tile
+    SparseTile* last = world->tiles[--world->tileCount];
+    world->tiles[tile->index] = last;
+    last->index = tile->index;
+
+    tile->next = world->freeTiles;
+    world->freeTiles = tile;
+}
+
+/**
+ * Checks if a live neighbour touches the side of the tile, so it could 
+ * be born into next generation
+ */
+static bool wanted(SparseWorld* world, SparseTile* tile) {
+    for (int d = 0; d < 8; d++) {
+        SparseTile* neighbour = tile->neighbours[d];
+
+        if (neighbour != NULL && (neighbour->edges[world->current] & (1 << (7 - d)))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Gets the neighbour directions a live cell at (x, y) in a tile touches
+ */
+static unsigned char edge_bits(int x, int y) {
+    int last = SPARSE_TILE_SIDE - 1;
+    unsigned char edges = 0;
+
+    if (y == 0) {
+        edges |= 1 << SPARSE_N;
+    }
+    if (y == last) {
+        edges |= 1 << SPARSE_S;
+    }
+    if (x == 0) {
+        edges |= 1 << SPARSE_W;
+    }
+    if (x == last) {
+        edges |= 1 << SPARSE_E;
+    }
+    if (x == 0 && y == 0) {
+        edges |= 1 << SPARSE_NW;
+    }
+    if (x == last && y == 0) {
+        edges |= 1 << SPARSE_NE;
+    }
+    if (x == 0 && y == last) {
+        edges |= 1 << SPARSE_SW;
+    }
+    if (x == last && y == last) {
+        edges |= 1 << SPARSE_SE;
+    }
+
+    return edges;
+}
\ No newline at end of file
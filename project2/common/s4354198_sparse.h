@@ -0,0 +1,81 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <stdbool.h>
+
+#include "s4354198_grid.h"
+
+/* Defines */
+#define SPARSE_TILE_SIDE 64
+#define SPARSE_INITIAL_BUCKETS 256
+// Neighbour directions, so that 7 - d is the opposite direction
+#define SPARSE_NW 0
+#define SPARSE_N 1
+#define SPARSE_NE 2
+#define SPARSE_W 3
+#define SPARSE_E 4
+#define SPARSE_SW 5
+#define SPARSE_S 6
+#define SPARSE_SE 7
+
+/*
+ * A square of the universe with a grid for each of the current and next
+ * generations. Before a tile is stepped its ghost cells are filled in 
+ * from its neighbours, so the grid kernels work on it unchanged. The
+ * flags say whether the tile has any live cells, and which neighbours
+ * its live cells touch, for each of the two grids.
+ */
+typedef struct SparseTile {
+    int tileX;
+    int tileY;
+    Grid* grids[2];
+    bool alive[2];
+    unsigned char edges[2];
+    uint64_t signature;
+    struct SparseTile* neighbours[8];
+    struct SparseTile* next;
+    int index;
+} SparseTile;
+
+/*
+ * An unbounded universe kept as a hash map of tiles. Tiles are only
+ * allocated next to live cells and freed again once they empty, so 
+ * memory follows the population rather than the area covered.
+ */
+typedef struct {
+    SparseTile** buckets;
+    int bucketCount;
+    SparseTile** tiles;
+    int tileCount;
+    int tileCapacity;
+    SparseTile* freeTiles;
+    int current;
+} SparseWorld;
+
+/* Function prototypes */
+SparseWorld* s4354198_sparse_create(void);
+void s4354198_sparse_clear(SparseWorld* world);
+SparseTile* s4354198_sparse_find(SparseWorld* world, int tileX, int tileY);
+CellId s4354198_sparse_get(SparseWorld* world, int x, int y);
+CellId s4354198_sparse_set(SparseWorld* world, int x, int y, CellId id);
+void s4354198_sparse_set_run(SparseWorld* world, int x, int y, int length, CellId id, 
+    CellId* previous);
+void s4354198_sparse_expand(SparseWorld* world);
+void s4354198_sparse_fill_halo(SparseWorld* world, SparseTile* tile);
+void s4354198_sparse_scan(SparseTile* tile, int which);
+void s4354198_sparse_flip(SparseWorld* world);
+void s4354198_sparse_remap(SparseWorld* world, const CellId* remap);
+void s4354198_sparse_load_tile(SparseWorld* world, int tileX, int tileY, 
+    const CellId* cells);
+uint64_t s4354198_sparse_signature(SparseWorld* world);
+void s4354198_sparse_capture(SparseWorld* world, int left, int top, int width, 
+    int height, CellId* cells);
+
+/**
+ * Rounds a division towards negative infinity, so cell -1 is in tile -1
+ */
+static inline int s4354198_sparse_floor_div(int value, int divisor) {
+    return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+#endif
\ No newline at end of file
@@ -5,12 +5,31 @@
 #include <X11/Xlib.h>
 
 #include "hdf5.h"
+#include "s4354198_defines.h"
+#include "s4354198_bitgrid.h"
+#include "s4354198_grid.h"
+#include "s4354198_census.h"
+#include "s4354198_idmap.h"
+#include "s4354198_activity.h"
+#include "s4354198_frame.h"
+#include "s4354198_hashlife.h"
+#include "s4354198_sparse.h"
+#include "s4354198_rule.h"
+#include "s4354198_cycle.h"
+#include "s4354198_history.h"
+#include "s4354198_queue.h"
+#include "s4354198_deque.h"
+#include "s4354198_pattern.h"
+#include "s4354198_ticker.h"
+#include "s4354198_snapshot.h"
+#include "s4354198_shard.h"
 
 typedef enum {
     CELL,
     STILL,
     OSC,
-    SHIP
+    SHIP,
+    PATTERN
 } LifeType;
 
 typedef enum {
@@ -23,7 +42,8 @@ typedef enum {
     BLINKER,
     TOAD,
     BEACON,
-    GLIDER
+    GLIDER,
+    IMPORTED
 } FormType;
 
 typedef enum {
@@ -40,10 +60,33 @@ typedef enum {
     STATE_FINISHED
 } StateType;
 
+typedef enum {
+    ENGINE_DIRECT,
+    ENGINE_BITS,
+    ENGINE_HASHLIFE,
+    ENGINE_SPARSE
+} EngineType;
+
 typedef struct {
     int width;
     int height;
     int refreshRate;
+    EngineType engine;
+    int stepLog;
+    bool large;
+    bool torus;
+    Rule rule;
+    int historyMegabytes;
+    // Generations a fast forward computes each tile for at a time, 0 or 1 
+    // for one at a time
+    int temporalDepth;
+    // Processes the board is split between, 0 or 1 to keep it in this one
+    int shards;
+    // Generations to benchmark each engine for, 0 runs normally
+    unsigned long benchGenerations;
+    char* benchPattern;
+    int benchDensity;
+    unsigned int benchSeed;
 } ShellArgs;
 
 typedef struct {
@@ -79,34 +122,122 @@ struct DrawingProcess {
     int x;
     int y;
     int id;
+    // Cells of an imported pattern, only kept until it is sent to the cag
+    Pattern* pattern;
     DrawingProcess* next;
     DrawingProcess* prev;
 };
 
 typedef struct LifeForm LifeForm;
 struct LifeForm {
+    // Must stay first, the queue hands back this node
+    QueueNode node;
     int id;
     int x;
     int y;
     LifeType lifeType;
     FormType formType;
-    LifeForm* next;
+    // Cells of an imported pattern, NULL for the built in forms
+    Pattern* pattern;
 };
 
 typedef struct {
-    int** oldState;
-    int** newState;
-    pthread_t* threads;
-    LifeForm* newLifeForms;    
+    pthread_t thread;
+    int index;
+    int rowStart;
+    int rowEnd;
+    // Generations of the current wavefront this worker's band has finished
+    int done;
+    // Tiles dealt to this worker for the current generation
+    Deque* tiles;
+    // Tiles this worker has taken from the others' deques
+    unsigned long steals;
+    // Tile and halo being stepped by temporal blocking
+    Grid* scratch[2];
+} Worker;
+
+// The buffers a generation is computed from and into
+typedef struct {
+    Grid* from;
+    Grid* to;
+    BitGrid* fromBits;
+    BitGrid* toBits;
+} Buffers;
+
+typedef struct {
+    char name[UNIVERSE_NAME_LENGTH + 1];
+    // Put before everything sent about this universe, empty for the default
+    char tag[UNIVERSE_NAME_LENGTH + 3];
+    // Rule of this universe, handed to the kernels whenever it is worked on
+    Rule rule;
+    Grid* oldState;
+    Grid* newState;
+    BitGrid* oldBits;
+    BitGrid* newBits;
+    // The worker pool, shared by every universe
+    Worker* workers;
+    int workerCount;
+    // Generations the workers compute as a wavefront, 0 for just the one
+    int waveGenerations;
+    // Generations each tile is taken on by temporal blocking, 0 for none
+    int blockGenerations;
+    // Scratch grids for the game loop's own temporal blocking
+    Grid* scratch[2];
+    Census* census;
+    IdMap* ids;
+    Activity* activity;
+    Hashlife* life;
+    SparseWorld* world;
+    // Strips of the board held by other processes, NULL when it is all here
+    ShardSet* shards;
+    Cycle* cycle;
+    History* history;
+    Ticker* ticker;
+    int viewX;
+    int viewY;
+    FrameWriter* frame;
+    Snapshot* snapshot;
+    unsigned long generation;
+    Queue* newLifeForms;
     bool paused;
 } Game;
 
+// Outcome of benchmarking one engine and kernel, passed back from its child
+typedef struct {
+    EngineType engine;
+    const char* kernel;
+    // Temporal block depth of a fast forward run, 0 when run tick by tick
+    int depth;
+    // Processes the board was split between, 0 when it was not
+    int shards;
+    bool supported;
+    int workers;
+    double seedSeconds;
+    double stepSeconds;
+    double cycleSeconds;
+    double frameSeconds;
+    unsigned long population;
+    uint64_t signature;
+} BenchResult;
+
 typedef struct {
     char* filename;
     bool loaded;
     hid_t file;
 } CFSInfo;
 
+/*
+ * A recorded frame as the runs of equal ids it was sent as, in row major 
+ * order over a board of its own size
+ */
+typedef struct {
+    int width;
+    int height;
+    int runCount;
+    // An id then how many cells it covers, for each run
+    int* runs;
+} RecordedFrame;
+
 typedef struct {
     char* volume;
     char* directory;
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+
+#include "s4354198_ticker.h"
+
+/* Function prototypes */
+static void add_nanoseconds(struct timespec* time, long nanoseconds);
+
+/**
+ * Creates a ticker whose first deadline is a period from now. Frames are 
+ * due every tick unless the period is 0.
+ */
+Ticker* s4354198_ticker_create(int milliseconds, int frameMilliseconds) {
+    Ticker* ticker = (Ticker*) malloc(sizeof(Ticker));
+    ticker->period = milliseconds * TICKER_MILLISECOND;
+    ticker->frameGap = (milliseconds == 0) ? frameMilliseconds * TICKER_MILLISECOND : 0;
+    ticker->ticks = 0;
+    ticker->missed = 0;
+    ticker->worstLate = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &(ticker->deadline));
+    ticker->lastFrame = ticker->deadline;
+
+    return ticker;
+}
+
+/**
+ * Sleeps until the next deadline. Unthrottled, a tick with no work to do
+ * waits as long as there is between frames instead.
+ */
+void s4354198_ticker_wait(Ticker* ticker, bool working) {
+    struct timespec now;
+
+    ticker->ticks++;
+
+    if (ticker->period == 0) {
+        struct timespec gap = {
+            .tv_sec = ticker->frameGap / TICKER_NANOSECONDS, 
+            .tv_nsec = ticker->frameGap % TICKER_NANOSECONDS
+        };
+
+        if (!working) {
+            clock_nanosleep(CLOCK_MONOTONIC, 0, &gap, NULL);
+        }
+        return;
+    }
+
+    add_nanoseconds(&(ticker->deadline), ticker->period);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    long late = s4354198_ticker_between(&(ticker->deadline), &now);
+    if (late > 0) {
+        ticker->missed++;
+        ticker->worstLate = (late > ticker->worstLate) ? late : ticker->worstLate;
+        ticker->deadline = now;
+        return;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &(ticker->deadline), NULL) == EINTR) {
+        ; // Interrupted by a signal, so go back to sleep
+    }
+}
+
+/**
+ * Checks if enough time has passed since the last frame to send another,
+ * and if so starts timing the next one
+ */
+bool s4354198_ticker_frame_due(Ticker* ticker) {
+    struct timespec now;
+
+    if (ticker->frameGap == 0) {
+        return true;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (s4354198_ticker_between(&(ticker->lastFrame), &now) < ticker->frameGap) {
+        return false;
+    }
+
+    ticker->lastFrame = now;
+
+    return true;
+}
+
+/**
+ * Moves a time on by some nanoseconds
+ */
+static void add_nanoseconds(struct timespec* time, long nanoseconds) {
+    time->tv_sec += nanoseconds / TICKER_NANOSECONDS;
+    time->tv_nsec += nanoseconds % TICKER_NANOSECONDS;
+
+    if (time->tv_nsec >= TICKER_NANOSECONDS) {
+        time->tv_sec++;
+        time->tv_nsec -= TICKER_NANOSECONDS;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef TICKER_H
+#define TICKER_H
+
+#include <stdbool.h>
+#include <time.h>
+
+/* Defines */
+#define TICKER_NANOSECONDS 1000000000L
+#define TICKER_MILLISECOND 1000000L
+
+/*
+ * Paces a loop against absolute deadlines on the monotonic clock, so the
+ * work done each tick does not stretch the period. A tick that starts 
+ * after its deadline is counted as missed and the deadlines start again
+ * from it, rather than rushing through the ones skipped. With a period of
+ * 0 the loop runs as fast as it can while it has work, and frameGap limits
+ * how often it is worth showing a frame.
+ */
+typedef struct {
+    struct timespec deadline;
+    long period;
+    long frameGap;
+    struct timespec lastFrame;
+    unsigned long ticks;
+    unsigned long missed;
+    long worstLate;
+} Ticker;
+
+/* Function prototypes */
+Ticker* s4354198_ticker_create(int milliseconds, int frameMilliseconds);
+void s4354198_ticker_wait(Ticker* ticker, bool working);
+bool s4354198_ticker_frame_due(Ticker* ticker);
+
+/**
+ * Gets the nanoseconds from one time to a later one
+ */
+static inline long s4354198_ticker_between(const struct timespec* start, 
+        const struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) * TICKER_NANOSECONDS + 
+        (end->tv_nsec - start->tv_nsec);
+}
+
+#endif
\ No newline at end of file
@@ -124,8 +124,20 @@ void s4354198_read_args(int argc, char** argv) {
     opterr = 0;
 
     app->shellArgs = (ShellArgs*) malloc(sizeof(ShellArgs));
+    app->shellArgs->engine = ENGINE_DIRECT;
+    app->shellArgs->stepLog = 0;
+    app->shellArgs->large = false;
+    app->shellArgs->torus = false;
+    app->shellArgs->historyMegabytes = HISTORY_DEFAULT_MEGABYTES;
+    app->shellArgs->temporalDepth = 0;
+    app->shellArgs->shards = 0;
+    app->shellArgs->benchGenerations = 0;
+    app->shellArgs->benchPattern = NULL;
+    app->shellArgs->benchDensity = BENCH_DEFAULT_DENSITY;
+    app->shellArgs->benchSeed = BENCH_DEFAULT_SEED;
+    s4354198_rule_parse(RULE_CONWAY, &(app->shellArgs->rule));
 
-    while ((chr = getopt(argc, argv, "w:h:r:")) != -1) {
+    while ((chr = getopt(argc, argv, "w:h:r:e:j:R:H:T:N:LtB:P:D:S:")) != -1) {
         switch (chr) {
             case 'w':
                 app->shellArgs->width = strtol(optarg, &endToken, 10);
@@ -136,6 +148,57 @@ void s4354198_read_args(int argc, char** argv) {
             case 'r':
                 app->shellArgs->refreshRate = strtol(optarg, &endToken, 10);
                 break;
+            case 'e':
+                if (s4354198_str_match(optarg, ENGINE_NAME_DIRECT)) {
+                    app->shellArgs->engine = ENGINE_DIRECT;
+                } else if (s4354198_str_match(optarg, ENGINE_NAME_BITS)) {
+                    app->shellArgs->engine = ENGINE_BITS;
+                } else if (s4354198_str_match(optarg, ENGINE_NAME_HASHLIFE)) {
+                    app->shellArgs->engine = ENGINE_HASHLIFE;
+                } else if (s4354198_str_match(optarg, ENGINE_NAME_SPARSE)) {
+                    app->shellArgs->engine = ENGINE_SPARSE;
+                } else {
+                    s4354198_exit(1, "Invalid engine (%s) specified. Must be '%s', '%s',"
+                        " '%s' or '%s'.\n", optarg, ENGINE_NAME_DIRECT, ENGINE_NAME_BITS, 
+                        ENGINE_NAME_HASHLIFE, ENGINE_NAME_SPARSE);
+                }
+                break;
+            case 'j':
+                app->shellArgs->stepLog = strtol(optarg, &endToken, 10);
+                break;
+            case 'R':
+                if (!s4354198_rule_parse(optarg, &(app->shellArgs->rule))) {
+                    s4354198_exit(1, "Invalid rule (%s) specified. Must be like '%s',"
+                        " with no births on 0 neighbours.\n", optarg, RULE_CONWAY);
+                }
+                break;
+            case 'H':
+                app->shellArgs->historyMegabytes = strtol(optarg, &endToken, 10);
+                break;
+            case 'T':
+                app->shellArgs->temporalDepth = strtol(optarg, &endToken, 10);
+                break;
+            case 'N':
+                app->shellArgs->shards = strtol(optarg, &endToken, 10);
+                break;
+            case 'L':
+                app->shellArgs->large = true;
+                break;
+            case 't':
+                app->shellArgs->torus = true;
+                break;
+            case 'B':
+                app->shellArgs->benchGenerations = strtoul(optarg, &endToken, 10);
+                break;
+            case 'P':
+                app->shellArgs->benchPattern = optarg;
+                break;
+            case 'D':
+                app->shellArgs->benchDensity = strtol(optarg, &endToken, 10);
+                break;
+            case 'S':
+                app->shellArgs->benchSeed = strtoul(optarg, &endToken, 10);
+                break;
             case '?':
                 if (isprint(optopt)) {
                     fprintf(stderr, "Unknown option '-%c'.\n", optopt);
@@ -149,19 +212,77 @@ void s4354198_read_args(int argc, char** argv) {
         }
     }
     
-    if (app->shellArgs->width > MAX_WIDTH || app->shellArgs->height < MIN_WIDTH) {
+    // Large boards are opt in, the display is only legible up to the normal size
+    int maxWidth = app->shellArgs->large ? LARGE_MAX_WIDTH : MAX_WIDTH;
+    int maxHeight = app->shellArgs->large ? LARGE_MAX_HEIGHT : MAX_HEIGHT;
+
+    if (app->shellArgs->width > maxWidth || app->shellArgs->width < MIN_WIDTH) {
         s4354198_exit(1, "Invalid width (%d) specified. Must be >= %d and <= %d.\n", 
-            app->shellArgs->width, MIN_WIDTH, MAX_WIDTH);
+            app->shellArgs->width, MIN_WIDTH, maxWidth);
     }
 
-    if (app->shellArgs->height > MAX_HEIGHT || app->shellArgs->height < MIN_HEIGHT) {
+    if (app->shellArgs->height > maxHeight || app->shellArgs->height < MIN_HEIGHT) {
         s4354198_exit(1, "Invalid height (%d) specified. Must be >= %d and <= %d.\n", 
-            app->shellArgs->height, MIN_HEIGHT, MAX_HEIGHT);
+            app->shellArgs->height, MIN_HEIGHT, maxHeight);
+    }
+
+    if (app->shellArgs->stepLog < 0 || app->shellArgs->stepLog > MAX_STEP_LOG) {
+        s4354198_exit(1, "Invalid step (%d) specified. Must be >= 0 and <= %d.\n", 
+            app->shellArgs->stepLog, MAX_STEP_LOG);
+    }
+
+    if (app->shellArgs->stepLog > 0 && app->shellArgs->engine != ENGINE_HASHLIFE) {
+        s4354198_exit(1, "Only the %s engine can step more than one generation"
+            " at a time.\n", ENGINE_NAME_HASHLIFE);
+    }
+
+    if (app->shellArgs->torus && (app->shellArgs->engine == ENGINE_HASHLIFE ||
+            app->shellArgs->engine == ENGINE_SPARSE)) {
+        s4354198_exit(1, "The %s engine is unbounded and cannot wrap at the edges.\n",
+            s4354198_engine_name(app->shellArgs->engine));
+    }
+
+    if (app->shellArgs->historyMegabytes < 0 || 
+            app->shellArgs->historyMegabytes > HISTORY_MAX_MEGABYTES) {
+        s4354198_exit(1, "Invalid history size (%d MB) specified. Must be >= 0 MB and"
+            " <= %d MB.\n", app->shellArgs->historyMegabytes, HISTORY_MAX_MEGABYTES);
+    }
+
+    if (app->shellArgs->temporalDepth < 0 || 
+            app->shellArgs->temporalDepth > TEMPORAL_MAX_DEPTH) {
+        s4354198_exit(1, "Invalid temporal block depth (%d) specified. Must be >= 0 and"
+            " <= %d.\n", app->shellArgs->temporalDepth, TEMPORAL_MAX_DEPTH);
+    }
+
+    if (app->shellArgs->temporalDepth > 1 && (app->shellArgs->torus || 
+            app->shellArgs->engine == ENGINE_HASHLIFE || 
+            app->shellArgs->engine == ENGINE_SPARSE)) {
+        s4354198_exit(1, "Temporal blocking needs the %s or %s engine without wrapping.\n",
+            ENGINE_NAME_DIRECT, ENGINE_NAME_BITS);
+    }
+
+    if (app->shellArgs->shards < 0 || app->shellArgs->shards > SHARD_MAX) {
+        s4354198_exit(1, "Invalid number of shards (%d) specified. Must be >= 0 and"
+            " <= %d.\n", app->shellArgs->shards, SHARD_MAX);
+    }
+
+    if (app->shellArgs->shards > 1 && (app->shellArgs->torus || 
+            app->shellArgs->engine != ENGINE_DIRECT || app->shellArgs->temporalDepth > 1)) {
+        s4354198_exit(1, "Sharding needs the %s engine without wrapping or temporal"
+            " blocking.\n", ENGINE_NAME_DIRECT);
     }
 
-    if (app->shellArgs->refreshRate > MAX_REFRESH || app->shellArgs->refreshRate < MIN_REFRESH) {
-        s4354198_exit(1, "Invalid refresh rate (%d ms) specified. Must be >= %d ms and"
-            " <= %d ms.\n", app->shellArgs->refreshRate, MIN_REFRESH, MAX_REFRESH);
+    if (app->shellArgs->benchDensity < 0 || app->shellArgs->benchDensity > 100) {
+        s4354198_exit(1, "Invalid soup density (%d%%) specified. Must be >= 0%% and"
+            " <= 100%%.\n", app->shellArgs->benchDensity);
+    }
+
+    // A refresh rate of 0 runs as fast as possible
+    if (app->shellArgs->refreshRate != 0 && (app->shellArgs->refreshRate > MAX_REFRESH || 
+            app->shellArgs->refreshRate < MIN_REFRESH)) {
+        s4354198_exit(1, "Invalid refresh rate (%d ms) specified. Must be 0 (as fast as"
+            " possible) or >= %d ms and <= %d ms.\n", app->shellArgs->refreshRate, 
+            MIN_REFRESH, MAX_REFRESH);
     }
 }
 
@@ -179,4 +300,38 @@ bool s4354198_is_white_space(char* input) {
     }
 
     return result;
+}
+
+/**
+ * Gets the command line name of an engine
+ */
+char* s4354198_engine_name(EngineType engine) {
+    switch (engine) {
+        case ENGINE_BITS:
+            return ENGINE_NAME_BITS;
+        case ENGINE_HASHLIFE:
+            return ENGINE_NAME_HASHLIFE;
+        case ENGINE_SPARSE:
+            return ENGINE_NAME_SPARSE;
+        case ENGINE_DIRECT:
+        default:
+            return ENGINE_NAME_DIRECT;
+    }
+}
+
+/**
+ * Checks a universe name is short enough to tag with and only uses 
+ * letters, digits, '_' and '-'
+ */
+bool s4354198_valid_universe_name(const char* name) {
+    if (strlen(name) == 0 || strlen(name) > UNIVERSE_NAME_LENGTH) {
+        return false;
+    }
+    for (const char* c = name; *c != '\0'; c++) {
+        if (!isalnum((unsigned char) *c) && *c != '_' && *c != '-') {
+            return false;
+        }
+    }
+
+    return true;
 }
\ No newline at end of file
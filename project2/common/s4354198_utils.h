@@ -4,6 +4,8 @@
 #include <stdarg.h>
 #include <semaphore.h>
 
+#include "s4354198_structs.h"
+
 /* Globals */
 // Holds the global input buffer
 char* globalInput;
@@ -14,5 +16,7 @@ bool s4354198_str_match(char *base, char *other);
 char* s4354198_getline(FILE *stream, int* totalSize, sem_t* lock);
 void s4354198_read_args(int argc, char** argv);
 bool s4354198_is_white_space(char* input);
+char* s4354198_engine_name(EngineType engine);
+bool s4354198_valid_universe_name(const char* name);
 
 #endif
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <X11/Xlib.h>
+#include <X11/Xutil.h>
 
 #include "../common/s4354198_structs.h"
 #include "../common/s4354198_defines.h"
@@ -529,6 +530,7 @@ void await_comms(void);
 void create_threads(void);
 void create_display(void);
 void update_screen(char* input);
+void fill_cells(int index, int count, unsigned long colour);
 void lock_print_to_cag(const char* format, ...);
 void *cag_output_handler(void* voidPtr);
 void *player_output_handler(void* voidPtr);
@@ -542,12 +544,20 @@ pthread_t cagOutput;
 pthread_t playerOutput;
 // Semaphore for output to the cag
 sem_t sendToCag;
+// Semaphore so only one frame is drawn at a time
+sem_t drawFrame;
+// Off screen copy of the window, pushed to the server once per frame
+XImage* image;
+// Size of the window in pixels
+int pixelsWide;
+int pixelsHigh;
 
 int main(int argc, char** argv) {
     app = (Application*) malloc(sizeof(Application));
     app->readyForDrawing = false;
 
     sem_init(&sendToCag, 0, 1);
+    sem_init(&drawFrame, 0, 1);
 
     s4354198_read_args(argc, argv);
 
@@ -598,12 +608,31 @@ void create_threads(void) {
 void create_display(void) {
     app->display = XOpenDisplay(0);
 
-    int blackColour = BlackPixel(app->display, DefaultScreen(app->display));
-    int whiteColour = WhitePixel(app->display, DefaultScreen(app->display));
+    int screen = DefaultScreen(app->display);
+    int blackColour = BlackPixel(app->display, screen);
+    int whiteColour = WhitePixel(app->display, screen);
+
+    // Cells keep their usual size until the window would get too big, 
+    // then the whole board is scaled down to fit
+    pixelsWide = app->shellArgs->width * CELL_SIDE;
+    pixelsHigh = app->shellArgs->height * CELL_SIDE;
+    if (pixelsWide > DISPLAY_MAX_SIDE || pixelsHigh > DISPLAY_MAX_SIDE) {
+        double scale = (double) DISPLAY_MAX_SIDE / 
+            ((app->shellArgs->width > app->shellArgs->height) ? 
+            app->shellArgs->width : app->shellArgs->height);
+
+        pixelsWide = (int) (app->shellArgs->width * scale);
+        pixelsHigh = (int) (app->shellArgs->height * scale);
+        if (pixelsWide < 1) {
+            pixelsWide = 1;
+        }
+        if (pixelsHigh < 1) {
+            pixelsHigh = 1;
+        }
+    }
 
     app->window = XCreateSimpleWindow(app->display, DefaultRootWindow(app->display),
-        0, 0, app->shellArgs->width * CELL_SIDE, app->shellArgs->height * CELL_SIDE,
-        0, blackColour, blackColour);
+        0, 0, pixelsWide, pixelsHigh, 0, blackColour, blackColour);
 
     XSelectInput(app->display, app->window, StructureNotifyMask);
 
@@ -613,16 +642,14 @@ void create_display(void) {
 
     XSetForeground(app->display, app->gc, whiteColour);
 
-    XFlush(app->display);
+    image = XCreateImage(app->display, DefaultVisual(app->display, screen), 
+        DefaultDepth(app->display, screen), ZPixmap, 0, NULL, pixelsWide, 
+        pixelsHigh, 32, 0);
+    image->data = (char*) calloc(image->bytes_per_line * pixelsHigh, sizeof(char));
 
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            XSetForeground(app->display, app->gc, blackColour);
-            XFillRectangle(app->display, app->window, app->gc, j * 20, i * 20, CELL_SIDE, CELL_SIDE);
-            
-            XFlush(app->display);
-        }
-    }
+    XPutImage(app->display, app->window, app->gc, image, 0, 0, 0, 0, 
+        pixelsWide, pixelsHigh);
+    XFlush(app->display);
 
     app->readyForDrawing = true;
 }
@@ -708,31 +735,63 @@ void lock_print_to_cag(const char *format, ...) {
  * Updates the screen
  */
 void update_screen(char *input) {
-    char* token;
-    char* endToken;
-    int inputLength = strlen(input) + 1;
-    char original[inputLength];
-    strncpy(original, input, inputLength);
-
-    int y = 0;
-    int x = 0;
-    int width = app->shellArgs->width;
-    while ((token = strsep(&input, ",")) != NULL) {
-        int id = strtol(token, &endToken, 10);
+    int index = 0;
+    int total = app->shellArgs->width * app->shellArgs->height;
+    int id;
+    int count;
 
-        if (id == 0) {
-            XSetForeground(app->display, app->gc, black);
-        } else {
-            XSetForeground(app->display, app->gc, colours[id % TOTAL_COLOURS]);
+    sem_wait(&drawFrame);
+
+    memset(image->data, 0, image->bytes_per_line * pixelsHigh);
+
+    while (index < total && s4354198_frame_next(&input, &id, &count)) {
+        if (count > total - index) {
+            count = total - index;
         }
-        XFillRectangle(app->display, app->window, app->gc, x * 20, y * 20, CELL_SIDE, CELL_SIDE);
-        
-        XFlush(app->display);
-
-        x++;
-        if (x == width) {
-            x = 0;
-            y++;
+
+        // Dead cells are already black
+        if (id != 0) {
+            fill_cells(index, count, colours[id % TOTAL_COLOURS]);
+        }
+
+        index += count;
+    }
+
+    XPutImage(app->display, app->window, app->gc, image, 0, 0, 0, 0, 
+        pixelsWide, pixelsHigh);
+    XFlush(app->display);
+
+    sem_post(&drawFrame);
+}
+
+/**
+ * Colours count cells in the image, starting from the given cell in 
+ * row major order. Every cell covers at least one pixel, so when the 
+ * board is scaled down a live cell is never lost to a dead neighbour.
+ */
+void fill_cells(int index, int count, unsigned long colour) {
+    int width = app->shellArgs->width;
+    int height = app->shellArgs->height;
+
+    for (int cell = index; cell < index + count; cell++) {
+        int y = cell / width;
+        int x = cell % width;
+        int top = (y * pixelsHigh) / height;
+        int bottom = ((y + 1) * pixelsHigh) / height;
+        int left = (x * pixelsWide) / width;
+        int right = ((x + 1) * pixelsWide) / width;
+
+        if (bottom == top) {
+            bottom++;
+        }
+        if (right == left) {
+            right++;
+        }
+
+        for (int i = top; i < bottom; i++) {
+            for (int j = left; j < right; j++) {
+                XPutPixel(image, j, i, colour);
+            }
         }
     }
 }
\ No newline at end of file
@@ -29,7 +29,8 @@ void lock_print_to_display(const char* format, ...);
 void *shell_output_handler(void* voidPtr);
 void *timer_handler(void* voidPtr);
 void *playback_handler(void* voidPtr);
-void send_to_display(int* data);
+void send_to_display(int frame);
+void push_fitted(RecordedFrame* recorded);
 
 /* Globals */
 // Contains application data
@@ -44,6 +45,8 @@ pthread_t playback;
 sem_t sendToShell;
 // Semaphore for output to the display
 sem_t sendToDisplay;
+// Frame being sent to the display
+FrameWriter* frameWriter;
 
 int main(int argc, char** argv) {
     app = (Application*) malloc(sizeof(Application));
@@ -54,6 +57,7 @@ int main(int argc, char** argv) {
 
     sem_init(&sendToShell, 0, 1);
     sem_init(&sendToDisplay, 0, 1);
+    frameWriter = s4354198_frame_writer_create();
 
     s4354198_read_args(argc, argv);
 
@@ -111,50 +115,70 @@ void* timer_handler(void* voidPtr) {
 }
 
 /**
- * Sends a frame to the screen
+ * Sends a frame to the screen, rebuilt from the runs it was recorded as.
+ * Frames are numbered from 1.
  */
-void send_to_display(int* data) {
-    char* messages[app->shellArgs->height];
-    int totalSize = 0;
-
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        int size = BUFFER_SIZE;
-        int index = 0;
-        char* message = (char*) malloc(sizeof(char) * size);
+void send_to_display(int frame) {
+    char* temp = strdup(app->prFile);
+    RecordedFrame* recorded = s4354198_get_file_frame_from_filename(temp, frame);
+    free(temp);
+
+    s4354198_frame_writer_reset(frameWriter);
+
+    if (recorded->width == app->shellArgs->width && 
+            recorded->height == app->shellArgs->height) {
+        for (int i = 0; i < recorded->runCount; i++) {
+            s4354198_frame_writer_push(frameWriter, recorded->runs[2 * i], 
+                recorded->runs[2 * i + 1]);
+        }
+    } else {
+        push_fitted(recorded);
+    }
 
-        for (int j = 0; j < app->shellArgs->width; j++) {
-            index += sprintf(&message[index], "%d", data[i * MAX_WIDTH + j]);
+    s4354198_free_file_frame(recorded);
 
-            if (j < app->shellArgs->width - 1) {
-                index += sprintf(&message[index], ",");
-            }
+    lock_print_to_display("%s\n", s4354198_frame_writer_finish(frameWriter));
+}
 
-            // Account for \n and \0
-            if (index == size - 2) {
-                size *= 2;
-                message = (char*) realloc(message, size);
-            }
+/**
+ * Sends a frame recorded on a board of another size, such as the padded 
+ * tiles of old recordings, cropped or padded with dead cells to this board
+ */
+void push_fitted(RecordedFrame* recorded) {
+    int width = app->shellArgs->width;
+    int height = app->shellArgs->height;
+    int kept = (recorded->width < width) ? recorded->width : width;
+    int run = 0;
+    int left = (recorded->runCount > 0) ? recorded->runs[1] : 0;
+
+    for (int y = 0; y < height; y++) {
+        if (y >= recorded->height) {
+            s4354198_frame_writer_push(frameWriter, 0, width);
+            continue;
         }
 
-        messages[i] = message;        
-        totalSize += strlen(message);
-    }
+        // Walk one recorded row, keeping only the cells on this board
+        for (int x = 0; x < recorded->width; ) {
+            while (left == 0 && run < recorded->runCount - 1) {
+                run++;
+                left = recorded->runs[2 * run + 1];
+            }
 
-    // Account for NUL terminator
-    totalSize++;
-    char finalMessage[totalSize + (app->shellArgs->height)];
-    int index = 0;
-    for (int i = 0; i < app->shellArgs->height; i++) {
-        index += sprintf(&finalMessage[index], "%s", messages[i]);
+            int id = (left > 0) ? recorded->runs[2 * run] : 0;
+            int step = (left > 0 && left < recorded->width - x) ? left : recorded->width - x;
 
-        if (i < app->shellArgs->height - 1) {
-            index += sprintf(&finalMessage[index], ",");
+            if (x < kept) {
+                s4354198_frame_writer_push(frameWriter, id, 
+                    (x + step < kept) ? step : kept - x);
+            }
+            x += step;
+            left = (left > step) ? left - step : 0;
         }
 
-        free(messages[i]);
+        if (kept < width) {
+            s4354198_frame_writer_push(frameWriter, 0, width - kept);
+        }
     }
-
-    lock_print_to_display("%s\n", finalMessage);
 }
 
 /**
@@ -167,13 +191,7 @@ void* playback_handler(void* voidPtr) {
             if (app->frame < app->maxFrame) {
                 lock_print_to_shell("Playing frame %d\n", app->frame);
 
-                char* temp = strdup(app->prFile);
-                int* data = s4354198_get_file_frame_from_filename(temp, app->frame + 1);
-
-                send_to_display(data);
-
-                free(data);
-                free(temp);
+                send_to_display(app->frame + 1);
 
                 app->frame++;
             } else {
@@ -188,7 +206,8 @@ void* playback_handler(void* voidPtr) {
             // Do nothing, just hold the time
         }
 
-        usleep(app->shellArgs->refreshRate * 1000);
+        // Recordings are for watching, so they never play unthrottled
+        usleep((app->shellArgs->refreshRate == 0 ? MIN_REFRESH : app->shellArgs->refreshRate) * 1000);
     }
     return NULL;
 }
@@ -227,6 +246,7 @@ void* shell_output_handler(void* voidPtr) {
                 app->prFile = strdup(strsep(&clone, " "));
                 app->frame = 0;
                 char* temp = strdup(app->prFile);
+                // Every frame is one sector
                 app->maxFrame = s4354198_get_file_sector_count_from_filename(temp);
                 free(temp);
                 app->pState = STATE_INIT;
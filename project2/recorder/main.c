@@ -21,6 +21,9 @@
 #include "../common/s4354198_externs.h"
 #include "../common/s4354198_cfs.h"
 
+/* Defines */
+#define RECORD_INITIAL_RUNS 1024
+
 /* Function prototypes */
 void await_comms(void);
 void create_threads(void);
@@ -28,6 +31,7 @@ void lock_print_to_shell(const char* format, ...);
 void *cag_output_handler(void* voidPtr);
 void *shell_output_handler(void* voidPtr);
 void *timer_handler(void* voidPtr);
+bool record_frame(char* input, RecordedFrame* frame, int* capacity);
 
 /* Globals */
 // Contains application data
@@ -116,13 +120,10 @@ void* cag_output_handler(void* voidPtr) {
     bool stop = false;
     char* input = NULL;
     char* cleanedInput = NULL;
-    char* endToken;
-    int* data = (int*) malloc(sizeof(int*) * MAX_HEIGHT * MAX_WIDTH);
+    // Runs are kept between frames and only grow
+    RecordedFrame frame = {app->shellArgs->width, app->shellArgs->height, 0, NULL};
+    int capacity = 0;
     size_t size;
-
-    for (int i = 0; i < MAX_HEIGHT * MAX_WIDTH; i++) {
-        data[i] = 0;
-    }
     
     while (!stop) {
         int read = getline(&input, &size, app->comms->fromCag);
@@ -144,17 +145,7 @@ void* cag_output_handler(void* voidPtr) {
             } else if (app->rState == STATE_STARTED) {
                 lock_print_to_shell("%lums: saving frame\n", app->upMilliseconds);
 
-                for (int i = 0; i < MAX_HEIGHT; i++) {
-                    for (int j = 0; j < MAX_WIDTH; j++) {
-                        if (i < app->shellArgs->width && j < app->shellArgs->height) {
-                            data[i * MAX_WIDTH + j] = strtol(strsep(&cleanedInput, ","), &endToken, 10);
-                        } else {
-                            data[i * MAX_WIDTH + j] = 0;
-                        }
-                    }
-                }
-
-                if (!s4354198_write_sector_to_file(app->prFile, data)) {
+                if (!record_frame(cleanedInput, &frame, &capacity)) {
                     lock_print_to_shell("Ran out of space\n");
                     lock_print_to_shell("%s\n", PR_CMD_DONE);
                     lock_print_to_shell("Recording saved to %s and ran for %lums\n", 
@@ -173,6 +164,40 @@ void* cag_output_handler(void* voidPtr) {
     return NULL;
 }
 
+/**
+ * Saves a frame as one sector holding its runs, however big the board.
+ * Returns false if the file system ran out of space.
+ */
+bool record_frame(char* input, RecordedFrame* frame, int* capacity) {
+    int id = 0;
+    int count = 0;
+
+    frame->runCount = 0;
+
+    while (s4354198_frame_next(&input, &id, &count)) {
+        if (count < 1) {
+            continue;
+        }
+
+        if (frame->runCount == *capacity) {
+            int grown = (*capacity == 0) ? RECORD_INITIAL_RUNS : *capacity * 2;
+            int* runs = (int*) realloc(frame->runs, sizeof(int) * 2 * grown);
+
+            if (runs == NULL) {
+                return false;
+            }
+            frame->runs = runs;
+            *capacity = grown;
+        }
+
+        frame->runs[2 * frame->runCount] = id;
+        frame->runs[2 * frame->runCount + 1] = count;
+        frame->runCount++;
+    }
+
+    return s4354198_write_frame_to_file(app->prFile, frame);
+}
+
 /**
  * Handler for shell output
  */
@@ -10,6 +10,7 @@
 #include <termios.h>
 #include <semaphore.h>
 #include <stdarg.h>
+#include <poll.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -21,6 +22,14 @@
 #include "../common/s4354198_externs.h"
 #include "../common/s4354198_cfs.h"
 
+/* Defines */
+// Passed to the children last, as NULL simply ends their arguments early
+#define LARGE_FLAG (app->shellArgs->large ? "-L" : NULL)
+// Most cells down or across a frame that cat prints
+#define CAT_MAX_SIDE 64
+// Room for one lifeform in a newbatch message
+#define NEWBATCH_ENTRY 64
+
 /* Function prototypes */
 void graceful_exit(void);
 void register_signal_handlers(void);
@@ -32,6 +41,7 @@ void prepare_for_draw_processes(void);
 void start_threads(void);
 void start_other_processes(void);
 void start_cag(void);
+char* cag_flags(char* buffer);
 void start_display(void);
 void start_recorder(void);
 void start_player(void);
@@ -45,12 +55,20 @@ void prompt(void);
 void restore_prompt(void);
 void await_input(void);
 void handle_user_input(char* input);
-void create_drawing_process(LifeType lifeType, FormType formType, int x, int y);
+void create_drawing_process(LifeType lifeType, FormType formType, int x, int y, Pattern* pattern);
 void notify_cag_new_lifeform(DrawingProcess* process);
+void notify_cag_pattern(DrawingProcess* process);
+void flush_new_lifeforms(void);
+bool input_waiting(void);
+bool is_draw_command(char* token);
+bool is_universe_command(char* token);
+void handle_universe(char* name, char* input);
 void remove_drawing_process(DrawingProcess* process);
 bool get_form_type(FormType* formType, char** input);
 bool get_form_coord(int* coord, char** input);
 bool handle_draw(char* input, LifeType lifeType);
+bool check_form_coords(int x, int y);
+void handle_import(char* input);
 void display_help(void);
 void kill_drawing(int id);
 void handle_life_form(void);
@@ -73,7 +91,13 @@ void handle_p(char* input);
 void handle_s(char* input);
 void handle_play(char* input);
 void handle_halp();
-void display_frame(int* data);
+void handle_view(char* input);
+void handle_rule(char* input);
+void handle_idle(char* input);
+void handle_ff(char* input);
+void handle_rewind(char* input);
+void handle_checkpoint(const char* command, char* input);
+void display_frame(RecordedFrame* frame);
 void display_nodes(INode* nodes);
 
 /* Globals */
@@ -99,6 +123,10 @@ sem_t sendToCag;
 sem_t sendToRecorder;
 // Semaphore for comms to the player
 sem_t sendToPlayer;
+// Lifeforms held back to be sent to the cag in one newbatch message
+char newBatch[NEWBATCH_MAX * NEWBATCH_ENTRY];
+int newBatchLength = 0;
+int newBatchCount = 0;
 
 /* Externs */
 extern char* formToString[];
@@ -277,6 +305,9 @@ void make_stdin_unbuffered(void) {
     newTio.c_lflag &=(~ICANON & ~ECHO);
 
     tcsetattr(STDIN_FILENO, TCSANOW, &newTio);
+
+    // Nothing can hide in stdio's buffer, so polling stdin sees all input
+    setvbuf(stdin, NULL, _IONBF, 0);
 }
 
 /**
@@ -338,8 +369,8 @@ void start_recorder(void) {
         }
         app->comms->fromRecord = fopen(FIFO_CR_SHELL, "r");
     } else {
-        char width[3];
-        char height[3];
+        char width[8];
+        char height[8];
         char refreshRate[5];
 
         sprintf(width, "%d", app->shellArgs->width);
@@ -347,7 +378,7 @@ void start_recorder(void) {
         sprintf(refreshRate, "%d", app->shellArgs->refreshRate);
 
         execl(CR_EXECUTABLE, CR_EXECUTABLE, "-w", width, "-h", 
-            height, "-r", refreshRate, NULL);
+            height, "-r", refreshRate, LARGE_FLAG, NULL);
         s4354198_exit(1, "execl failed to create recorder process.\n");
     }
 }
@@ -372,8 +403,8 @@ void start_player(void) {
         }
         app->comms->fromPlayer = fopen(FIFO_CP_SHELL, "r");
     } else {
-        char width[3];
-        char height[3];
+        char width[8];
+        char height[8];
         char refreshRate[5];
 
         sprintf(width, "%d", app->shellArgs->width);
@@ -381,7 +412,7 @@ void start_player(void) {
         sprintf(refreshRate, "%d", app->shellArgs->refreshRate);
 
         execl(CP_EXECUTABLE, CP_EXECUTABLE, "-w", width, "-h", 
-            height, "-r", refreshRate, NULL);
+            height, "-r", refreshRate, LARGE_FLAG, NULL);
         s4354198_exit(1, "execl failed to create player process.\n");
     }
 }
@@ -406,20 +437,51 @@ void start_cag(void) {
         }
         app->comms->fromCag = fopen(FIFO_CAG_SHELL, "r");
     } else {
-        char width[3];
-        char height[3];
+        char width[8];
+        char height[8];
         char refreshRate[5];
+        char stepLog[4];
+        char history[8];
+        char temporal[4];
+        char shards[4];
+        char flags[4];
 
         sprintf(width, "%d", app->shellArgs->width);
         sprintf(height, "%d", app->shellArgs->height);
         sprintf(refreshRate, "%d", app->shellArgs->refreshRate);
+        sprintf(stepLog, "%d", app->shellArgs->stepLog);
+        sprintf(history, "%d", app->shellArgs->historyMegabytes);
+        sprintf(temporal, "%d", app->shellArgs->temporalDepth);
+        sprintf(shards, "%d", app->shellArgs->shards);
 
         execl(CAG_EXECUTABLE, CAG_EXECUTABLE, "-w", width, "-h", 
-            height, "-r", refreshRate, NULL);
+            height, "-r", refreshRate, "-e",
+            s4354198_engine_name(app->shellArgs->engine), "-j", stepLog, 
+            "-R", app->shellArgs->rule.name, "-H", history, "-T", temporal, 
+            "-N", shards, cag_flags(flags), NULL);
         s4354198_exit(1, "execl failed to create cag process.\n");
     }
 }
 
+/**
+ * Builds the on/off options for cag as one argument, like "-Lt", or NULL
+ * when none are set
+ */
+char* cag_flags(char* buffer) {
+    int length = 0;
+
+    buffer[length++] = '-';
+    if (app->shellArgs->large) {
+        buffer[length++] = 'L';
+    }
+    if (app->shellArgs->torus) {
+        buffer[length++] = 't';
+    }
+    buffer[length] = '\0';
+
+    return (length > 1) ? buffer : NULL;
+}
+
 /**
  * Forks and starts the X11-based display process
  */
@@ -432,8 +494,8 @@ void start_display(void) {
     } else if (pid > 0) {
         app->runtimeInfo->display = pid;
     } else {
-        char width[3];
-        char height[3];
+        char width[8];
+        char height[8];
         char refreshRate[5];
 
         sprintf(width, "%d", app->shellArgs->width);
@@ -441,7 +503,7 @@ void start_display(void) {
         sprintf(refreshRate, "%d", app->shellArgs->refreshRate);
 
         execl(DISPLAY_EXECUTABLE, DISPLAY_EXECUTABLE, "-w", width, "-h", 
-            height, "-r", refreshRate, NULL);
+            height, "-r", refreshRate, LARGE_FLAG, NULL);
         s4354198_exit(1, "execl failed to create display process.\n");
     }
 }
@@ -530,6 +592,11 @@ void await_input(void) {
     int size;
 
     while (!stop) {
+        // Drawings are only held back while more commands are already waiting
+        if (!input_waiting()) {
+            flush_new_lifeforms();
+        }
+
         sem_wait(&outputAllowed);
         prompt();
         sem_post(&outputAllowed);
@@ -552,11 +619,42 @@ void await_input(void) {
         }
     }
 
+    flush_new_lifeforms();
+
     sem_wait(&outputAllowed);
     restore_prompt();
     sem_post(&outputAllowed);
 }
 
+/**
+ * Checks if there is more input waiting to be read
+ */
+bool input_waiting(void) {
+    struct pollfd pollStdin = {.fd = STDIN_FILENO, .events = POLLIN};
+
+    return poll(&pollStdin, 1, 0) > 0;
+}
+
+/**
+ * Checks if a command draws a lifeform
+ */
+bool is_draw_command(char* token) {
+    return s4354198_str_match(token, CMD_CELL) || s4354198_str_match(token, CMD_STILL) ||
+        s4354198_str_match(token, CMD_OSC) || s4354198_str_match(token, CMD_SHIP);
+}
+
+/**
+ * Checks if a command only runs the universe, so can be sent to a named one
+ */
+bool is_universe_command(char* token) {
+    return s4354198_str_match(token, CMD_START) || s4354198_str_match(token, CMD_STOP) ||
+        s4354198_str_match(token, CMD_CLEAR) || s4354198_str_match(token, CMD_STATS) ||
+        s4354198_str_match(token, CMD_VIEW) || s4354198_str_match(token, CMD_RULE) ||
+        s4354198_str_match(token, CMD_IDLE) || s4354198_str_match(token, CMD_FF) ||
+        s4354198_str_match(token, CMD_REWIND) || s4354198_str_match(token, CMD_CHECKPOINT) ||
+        s4354198_str_match(token, CMD_RESTORE);
+}
+
 /**
  * Perform actions depending on user input
  */
@@ -574,6 +672,11 @@ void handle_user_input(char* input) {
         return;
     }
 
+    // Everything else has to reach the cag after the drawings before it
+    if (!is_draw_command(token)) {
+        flush_new_lifeforms();
+    }
+
     if (s4354198_str_match(token, CMD_CELL)) {
         handle_draw(input, CELL);
     } else if (s4354198_str_match(token, CMD_STILL)) {
@@ -595,6 +698,25 @@ void handle_user_input(char* input) {
     } else if (s4354198_str_match(token, CMD_CLEAR)) {
         fprintf(app->comms->toCag, "%s\n", COMMS_CLEAR);
         fflush(app->comms->toCag);
+    } else if (s4354198_str_match(token, CMD_STATS)) {
+        fprintf(app->comms->toCag, "%s\n", COMMS_STATS);
+        fflush(app->comms->toCag);
+    } else if (s4354198_str_match(token, CMD_VIEW)) {
+        handle_view(input);
+    } else if (s4354198_str_match(token, CMD_RULE)) {
+        handle_rule(input);
+    } else if (s4354198_str_match(token, CMD_IDLE)) {
+        handle_idle(input);
+    } else if (s4354198_str_match(token, CMD_FF)) {
+        handle_ff(input);
+    } else if (s4354198_str_match(token, CMD_REWIND)) {
+        handle_rewind(input);
+    } else if (s4354198_str_match(token, CMD_CHECKPOINT)) {
+        handle_checkpoint(COMMS_CHECKPOINT, input);
+    } else if (s4354198_str_match(token, CMD_RESTORE)) {
+        handle_checkpoint(COMMS_RESTORE, input);
+    } else if (s4354198_str_match(token, CMD_IMPORT)) {
+        handle_import(input);
     } else if (s4354198_str_match(token, CMD_HELP)) {
         display_help();
     } else if (s4354198_str_match(token, CMD_END)) {
@@ -625,6 +747,8 @@ void handle_user_input(char* input) {
         handle_touch(input);
     } else if (s4354198_str_match(token, CMD_HALP)) {
         handle_halp();
+    } else if (token[0] == UNIVERSE_TAG) {
+        handle_universe(token + 1, input);
     } else if (s4354198_str_match(token, CMD_TOGGLE_DRAWINGS_OUT)) {
         app->drawingsSTFU = !app->drawingsSTFU;
         if (app->drawingsSTFU) {
@@ -647,6 +771,31 @@ void handle_user_input(char* input) {
     }
 }
 
+/**
+ * Sends a command on to one of the named universes the cag hosts, which 
+ * checks its arguments. Drawings are only kept track of for the default 
+ * universe, so they cannot be sent.
+ */
+void handle_universe(char* name, char* input) {
+    if (!s4354198_valid_universe_name(name)) {
+        return lock_print(PROMPT_ERROR"Invalid universe name '%s'\n"PROMPT_RESET, name);
+    }
+
+    char* token = strsep(&input, " ");
+
+    if (token == NULL || strlen(token) == 0) {
+        return lock_print(PROMPT_ERROR"Usage: @<name> <command>\n"PROMPT_RESET);
+    }
+    if (!is_universe_command(token)) {
+        return lock_print(PROMPT_ERROR"Cannot send '%s' to another universe\n"PROMPT_RESET, 
+            token);
+    }
+
+    fprintf(app->comms->toCag, "%c%s %s%s%s\n", UNIVERSE_TAG, name, token, 
+        (input == NULL) ? "" : " ", (input == NULL) ? "" : input);
+    fflush(app->comms->toCag);
+}
+
 /**
  * Handle mounting of HDF file system
  */
@@ -772,65 +921,68 @@ void display_nodes(INode* nodes) {
 }
 
 /**
- * Displays a frame
+ * Displays a frame, or its top left corner if the board was too big to
+ * show whole
  */
-void display_frame(int* data) {
-    int widths[MAX_WIDTH];
-    for (int i = 0; i < MAX_WIDTH; i++) {
-        widths[i] = 0;
+void display_frame(RecordedFrame* frame) {
+    int shownWidth = (frame->width < CAT_MAX_SIDE) ? frame->width : CAT_MAX_SIDE;
+    int shownHeight = (frame->height < CAT_MAX_SIDE) ? frame->height : CAT_MAX_SIDE;
+    int* data = (int*) calloc(shownWidth * shownHeight, sizeof(int));
+    long cell = 0;
+
+    // Unpack just the cells that are shown
+    for (int i = 0; i < frame->runCount && cell / frame->width < shownHeight; i++) {
+        for (int j = 0; j < frame->runs[2 * i + 1]; j++, cell++) {
+            int x = cell % frame->width;
+            int y = cell / frame->width;
+
+            if (y >= shownHeight) {
+                break;
+            }
+            if (x < shownWidth) {
+                data[y * shownWidth + x] = frame->runs[2 * i];
+            }
+        }
     }
-    int items = MAX_HEIGHT;
 
     char temp[50];
+    int width = 0;
 
-    for (int i = 0; i < MAX_HEIGHT; i++) {
-        for (int j = 0; j < MAX_WIDTH; j++) {
-            int val = data[i * MAX_WIDTH + j];
-            sprintf(temp, "%d", val);
+    for (int i = 0; i < shownWidth * shownHeight; i++) {
+        sprintf(temp, "%d", data[i]);
 
-            for (int k = 0; k < MAX_WIDTH; k++) {
-                if (strlen(temp) > widths[k]) {
-                    widths[k] = strlen(temp);
-                }
-            }
+        if (strlen(temp) > width) {
+            width = strlen(temp);
         }
     }
 
-    int maxLineLength = 20;
-    for (int i = 0; i < MAX_WIDTH; i++) {
-        maxLineLength += widths[i] + 2;
-    }
-
-    char** formats = (char**) malloc(sizeof(char*) * MAX_WIDTH);
-    for (int i = 0; i < MAX_WIDTH; i++) {
-        formats[i] = (char*) malloc(sizeof(char) * 300);
-        sprintf(formats[i], "%%-%ds", widths[i]);
-    }
-    char* output = (char*) malloc(sizeof(char) * maxLineLength * (items + 2));
+    char* output = (char*) malloc(sizeof(char) * ((width + 1) * shownWidth + 1) * 
+        shownHeight + 100);
     int index = 0;
     
-    for (int i = 0; i < MAX_HEIGHT; i++) {
-        for (int j = 0; j < MAX_WIDTH; j++) {
-            int val = data[i * MAX_WIDTH + j];
-            sprintf(temp, "%d", val);
-            index += sprintf(&(output[index]), formats[j], temp);
+    for (int i = 0; i < shownHeight; i++) {
+        for (int j = 0; j < shownWidth; j++) {
+            index += sprintf(&(output[index]), "%-*d", width, data[i * shownWidth + j]);
             
-            if (j < MAX_WIDTH - 1) {
+            if (j < shownWidth - 1) {
                 index += sprintf(&(output[index]), " ");
             }
         }
         index += sprintf(&(output[index]), "\n");
     }
 
-    // Free
-    for (int i = 0; i < MAX_WIDTH; i++) {
-        free(formats[i]);
+    if (shownWidth < frame->width || shownHeight < frame->height) {
+        sprintf(&(output[index]), "(top left %dx%d of %dx%d shown)\n", shownWidth, 
+            shownHeight, frame->width, frame->height);
     }
-    free(formats);
+
+    // Free
     free(data);
+    s4354198_free_file_frame(frame);
 
     // Print
     lock_print(PROMPT_RESET"%s", output);
+    free(output);
 }
 
 /**
@@ -1101,9 +1253,7 @@ void handle_frame(char* input) {
                 frame, origPath, sectors, sectors);
         }
 
-        int* data = s4354198_get_file_frame(pathInfo, frame);
-
-        display_frame(data);
+        display_frame(s4354198_get_file_frame(pathInfo, frame));
 
         s4354198_path_free_info(pathInfo); 
         free(origPtr);
@@ -1252,7 +1402,7 @@ void handle_size(char* input) {
         // Get the file sectors
         int sectors = s4354198_get_file_sector_count(pathInfo);
         lock_print("'%s' is roughly %.3fkB (%d sectors)\n", 
-            origPath, (sectors * MAX_WIDTH * MAX_HEIGHT * sizeof(int)) / 1024.0f, sectors);
+            origPath, s4354198_get_file_bytes(pathInfo) / 1024.0f, sectors);
         
         s4354198_path_free_info(pathInfo); 
         free(origPtr);
@@ -1271,15 +1421,17 @@ void handle_free(char* input) {
         return lock_print(ERR_NO_MOUNTED);
     }
 
-    int used = s4354198_get_used_sectors();
+    long bytes;
+    int used = s4354198_get_used_sectors(&bytes);
     int total = CFS_VOLUME_COUNT * CFS_VOLUME_SECTORS;
-    int secSize = MAX_WIDTH * MAX_HEIGHT * sizeof(int);
 
-    lock_print("%.3fkB/%.3fkB free (%d/%d sectors used)\n", 
-        ((total - used) * secSize) / 1024.0f,
-        (total * secSize) / 1024.0f,
-        used,
-        total
+    // Sectors are sized to the frame written to them, so only what is used
+    // has a size
+    lock_print("%d/%d sectors free (%.3fkB used by %d sectors)\n", 
+        total - used,
+        total,
+        bytes / 1024.0f,
+        used
     );
 }
 
@@ -1568,19 +1720,7 @@ bool handle_draw(char* input, LifeType lifeType) {
         return false;
     }
 
-    if (x > app->shellArgs->width) {
-        lock_print(PROMPT_ERROR"X Coordinate must be >= 1 and <= %d (%d).\n"PROMPT_RESET,
-            app->shellArgs->width,
-            x
-        );
-        return false;
-    }
-
-    if (y > app->shellArgs->height) {
-        lock_print(PROMPT_ERROR"Y Coordinate must be >= 1 and <= %d (%d).\n"PROMPT_RESET,
-            app->shellArgs->height,
-            y
-        );
+    if (!check_form_coords(x, y)) {
         return false;
     }
 
@@ -1598,6 +1738,9 @@ bool handle_draw(char* input, LifeType lifeType) {
         case SHIP:
             invalidForm = (formType != GLIDER);
             break;
+        case PATTERN:
+            invalidForm = (formType != IMPORTED);
+            break;
     }
 
     if (invalidForm) {
@@ -1608,15 +1751,68 @@ bool handle_draw(char* input, LifeType lifeType) {
         return false;
     }
 
-    create_drawing_process(lifeType, formType, x, y);
+    create_drawing_process(lifeType, formType, x, y, NULL);
 
     return true;
 }
 
+/**
+ * Checks that coordinates given to a drawing are on the board
+ */
+bool check_form_coords(int x, int y) {
+    if (x > app->shellArgs->width) {
+        lock_print(PROMPT_ERROR"X Coordinate must be >= 1 and <= %d (%d).\n"PROMPT_RESET,
+            app->shellArgs->width,
+            x
+        );
+        return false;
+    }
+
+    if (y > app->shellArgs->height) {
+        lock_print(PROMPT_ERROR"Y Coordinate must be >= 1 and <= %d (%d).\n"PROMPT_RESET,
+            app->shellArgs->height,
+            y
+        );
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Handles the import command, drawing an RLE or Life 1.06 pattern file
+ * with its top left corner at the coordinates
+ */
+void handle_import(char* input) {
+    const char* error;
+    char* path = strsep(&input, " ");
+    int x;
+    int y;
+
+    if (path == NULL || strlen(path) == 0) {
+        return lock_print(PROMPT_ERROR"Usage: import <file> <x> <y>\n"PROMPT_RESET);
+    }
+
+    if (!get_form_coord(&x, &input) || !get_form_coord(&y, &input) || 
+            !check_form_coords(x, y)) {
+        return;
+    }
+
+    Pattern* pattern = s4354198_pattern_load(path, &error);
+    if (pattern == NULL) {
+        return lock_print(PROMPT_ERROR"Unable to import %s (%s)\n"PROMPT_RESET, path, error);
+    }
+
+    lock_print("Imported %ld cells (%dx%d) from %s\n", s4354198_pattern_count(pattern),
+        pattern->width, pattern->height, path);
+
+    create_drawing_process(PATTERN, IMPORTED, x, y, pattern);
+}
+
 /**
  * Creates a new drawing process with supplied types and coords
  */
-void create_drawing_process(LifeType lifeType, FormType formType, int x, int y) {
+void create_drawing_process(LifeType lifeType, FormType formType, int x, int y, Pattern* pattern) {
     DrawingProcess* start = app->drawProcesses;
     DrawingProcess* last = app->drawProcesses;
     DrawingProcess* new = (DrawingProcess*) malloc(sizeof(DrawingProcess));
@@ -1631,6 +1827,7 @@ void create_drawing_process(LifeType lifeType, FormType formType, int x, int y)
     new->x = x;
     new->y = y;
     new->id = 0;
+    new->pattern = pattern;
 
     // Special case of DEAD
     if (formType == DEAD) {
@@ -1680,18 +1877,65 @@ void create_drawing_process(LifeType lifeType, FormType formType, int x, int y)
 }
 
 /**
- * Notify the CAG that a new lifeform has been created
+ * Notify the CAG that a new lifeform has been created. Lifeforms are held
+ * back and sent together by flush_new_lifeforms.
  */
 void notify_cag_new_lifeform(DrawingProcess* process) {
-    fprintf(app->comms->toCag, "%s %d %d %d %d %d\n", 
-        COMMS_NEW,
+    if (process->pattern != NULL) {
+        return notify_cag_pattern(process);
+    }
+
+    newBatchLength += snprintf(newBatch + newBatchLength, NEWBATCH_ENTRY, "%s%d %d %d %d %d",
+        (newBatchCount == 0) ? "" : NEWBATCH_SEPARATOR,
         process->id,
         (int) process->lifeType,
         (int) process->formType,
         process->x,
         process->y
     );
+
+    if (++newBatchCount == NEWBATCH_MAX) {
+        flush_new_lifeforms();
+    }
+}
+
+/**
+ * Sends an imported pattern to the CAG as its packed rows, straight after
+ * the line describing it, then frees the pattern
+ */
+void notify_cag_pattern(DrawingProcess* process) {
+    Pattern* pattern = process->pattern;
+
+    // Drawings before the pattern have to reach the cag first
+    flush_new_lifeforms();
+
+    sem_wait(&sendToCag);
+    // Other threads write to the cag too and must not land inside the rows
+    flockfile(app->comms->toCag);
+    fprintf(app->comms->toCag, "%s %d %d %d %d %d\n", COMMS_PATTERN, process->id, 
+        process->x, process->y, pattern->width, pattern->height);
+    fwrite(pattern->bits, 1, s4354198_pattern_bytes(pattern), app->comms->toCag);
     fflush(app->comms->toCag);
+    funlockfile(app->comms->toCag);
+    sem_post(&sendToCag);
+
+    s4354198_pattern_free(pattern);
+    process->pattern = NULL;
+}
+
+/**
+ * Sends the held back lifeforms to the CAG, as a plain new message when
+ * there is only one
+ */
+void flush_new_lifeforms(void) {
+    if (newBatchCount == 0) {
+        return;
+    }
+
+    lock_print_to_cag("%s %s\n", (newBatchCount == 1) ? COMMS_NEW : COMMS_NEWBATCH, newBatch);
+
+    newBatchLength = 0;
+    newBatchCount = 0;
 }
 
 /**
@@ -1746,6 +1990,38 @@ void display_help(void) {
                              "Stop all cellular automation\n\n"
         PROMPT_HELP"clear                "PROMPT_RESET
                              "Clear all visual cellular automation\n\n"
+        PROMPT_HELP"stats                "PROMPT_RESET
+                             "Show the engine's generation, kernel and the\n"
+        "                     fraction of the board still active.\n\n"
+        PROMPT_HELP"view <x> <y>         "PROMPT_RESET
+                             "Move the top left of the board to (x, y) of an\n"
+        "                     unbounded universe (hashlife or sparse engine).\n\n"
+        PROMPT_HELP"rule <rule>          "PROMPT_RESET
+                             "Change the rule, like B3/S23 or B36/S23. Shows\n"
+        "                     the current rule when none is given.\n\n"
+        PROMPT_HELP"idle <on|off>        "PROMPT_RESET
+                             "Stop computing once the board dies out or\n"
+        "                     repeats, replaying the cycle instead.\n\n"
+        PROMPT_HELP"ff <n>               "PROMPT_RESET
+                             "Compute n generations as fast as possible and\n"
+        "                     show the last one. Start with -T to compute\n"
+        "                     that many generations per pass over the board.\n\n"
+        PROMPT_HELP"rewind <n>           "PROMPT_RESET
+                             "Go back n generations, as far as the history\n"
+        "                     kept with -H allows.\n\n"
+        PROMPT_HELP"checkpoint <file>    "PROMPT_RESET
+                             "Save the board and its lifeforms to a file.\n"
+        "                     Lifeforms still to be drawn are drawn first.\n\n"
+        PROMPT_HELP"restore <file>       "PROMPT_RESET
+                             "Replace the board with one saved by checkpoint.\n\n"
+        PROMPT_HELP"import <file> <x> <y>"PROMPT_RESET
+                             "Draw an RLE or Life 1.06 pattern file with its\n"
+        "                     top left corner at x and y.\n\n"
+        PROMPT_HELP"@<name> <command>    "PROMPT_RESET
+                             "Run start, stop, clear, stats, view, rule,\n"
+        "                     idle, ff, rewind, checkpoint or restore on the\n"
+        "                     named universe, made the first time it is named.\n"
+        "                     Only the default universe is drawn and shown.\n\n"
         PROMPT_HELP"mount <hdf5 file>    "PROMPT_RESET
                              "Create new or open existing specified HDF5 file\n"
         "                     for the CFS to be used.\n\n"
@@ -1935,10 +2211,29 @@ void* engine_out_handler(void* voidPtr) {
 
             token = strsep(&cleanedInput, " ");
 
+            // Deaths and ids of the named universes are not the shell's drawings
+            if (token[0] == UNIVERSE_TAG && cleanedInput != NULL) {
+                char* reply = strsep(&cleanedInput, " ");
+
+                if (s4354198_str_match(reply, COMMS_DEAD) || 
+                        s4354198_str_match(reply, COMMS_LAST_ID)) {
+                    free(originalPtr);
+                    continue;
+                }
+            }
+
             if (s4354198_str_match(token, COMMS_DEAD)) {
-                token = strsep(&cleanedInput, " ");
-                int id = strtol(token, &endToken, 10);
-                kill_drawing(id);
+                // The engine batches every death from a tick into one message
+                while ((token = strsep(&cleanedInput, " ")) != NULL) {
+                    int id = strtol(token, &endToken, 10);
+                    kill_drawing(id);
+                }
+            } else if (s4354198_str_match(token, COMMS_LAST_ID)) {
+                // A restored board already uses ids up to this one
+                int id = (cleanedInput == NULL) ? 0 : strtol(cleanedInput, &endToken, 10);
+                if (id > app->lastId) {
+                    app->lastId = id;
+                }
             } else {
                 int charsToDelete = strlen(PROMPT);
     
@@ -2104,6 +2399,121 @@ void* player_out_handler(void* voidPtr) {
     return NULL;
 }
 
+/**
+ * Handles the view command
+ */
+void handle_view(char* input) {
+    char* endToken;
+    int coords[2];
+
+    for (int i = 0; i < 2; i++) {
+        char* token = strsep(&input, " ");
+
+        if (token == NULL || strlen(token) == 0) {
+            return lock_print(PROMPT_ERROR"Usage: view <x> <y>\n"PROMPT_RESET);
+        }
+
+        coords[i] = strtol(token, &endToken, 10);
+        if (*endToken != '\0') {
+            return lock_print(PROMPT_ERROR"Invalid coordinate '%s'\n"PROMPT_RESET, token);
+        }
+    }
+
+    fprintf(app->comms->toCag, "%s %d %d\n", COMMS_VIEW, coords[0], coords[1]);
+    fflush(app->comms->toCag);
+}
+
+/**
+ * Handles the ff command
+ */
+void handle_ff(char* input) {
+    char* endToken;
+    char* token = strsep(&input, " ");
+
+    if (token == NULL || strlen(token) == 0) {
+        return lock_print(PROMPT_ERROR"Usage: ff <n>\n"PROMPT_RESET);
+    }
+
+    unsigned long generations = strtoul(token, &endToken, 10);
+    if (*endToken != '\0' || generations == 0 || token[0] == '-') {
+        return lock_print(PROMPT_ERROR"Invalid number of generations '%s'\n"PROMPT_RESET,
+            token);
+    }
+
+    fprintf(app->comms->toCag, "%s %lu\n", COMMS_FF, generations);
+    fflush(app->comms->toCag);
+}
+
+/**
+ * Handles the rewind command
+ */
+void handle_rewind(char* input) {
+    char* endToken;
+    char* token = strsep(&input, " ");
+
+    if (token == NULL || strlen(token) == 0) {
+        return lock_print(PROMPT_ERROR"Usage: rewind <n>\n"PROMPT_RESET);
+    }
+
+    unsigned long generations = strtoul(token, &endToken, 10);
+    if (*endToken != '\0' || generations == 0 || token[0] == '-') {
+        return lock_print(PROMPT_ERROR"Invalid number of generations '%s'\n"PROMPT_RESET,
+            token);
+    }
+
+    fprintf(app->comms->toCag, "%s %lu\n", COMMS_REWIND, generations);
+    fflush(app->comms->toCag);
+}
+
+/**
+ * Handles the checkpoint and restore commands, which both take a file
+ * that cag opens itself
+ */
+void handle_checkpoint(const char* command, char* input) {
+    if (input == NULL || s4354198_is_white_space(input)) {
+        return lock_print(PROMPT_ERROR"Usage: %s <file>\n"PROMPT_RESET, command);
+    }
+
+    fprintf(app->comms->toCag, "%s %s\n", command, input);
+    fflush(app->comms->toCag);
+}
+
+/**
+ * Handles the idle command
+ */
+void handle_idle(char* input) {
+    char* token = strsep(&input, " ");
+
+    if (token == NULL || (!s4354198_str_match(token, COMMS_ON) && 
+            !s4354198_str_match(token, COMMS_OFF))) {
+        return lock_print(PROMPT_ERROR"Usage: idle <on|off>\n"PROMPT_RESET);
+    }
+
+    fprintf(app->comms->toCag, "%s %s\n", COMMS_IDLE, token);
+    fflush(app->comms->toCag);
+}
+
+/**
+ * Handles the rule command
+ */
+void handle_rule(char* input) {
+    Rule rule;
+    char* token = strsep(&input, " ");
+
+    if (token == NULL || strlen(token) == 0) {
+        return lock_print("Rule is %s\n", app->shellArgs->rule.name);
+    }
+
+    if (!s4354198_rule_parse(token, &rule)) {
+        return lock_print(PROMPT_ERROR"Invalid rule '%s', must be like %s with no"
+            " births on 0 neighbours\n"PROMPT_RESET, token, RULE_CONWAY);
+    }
+
+    app->shellArgs->rule = rule;
+    fprintf(app->comms->toCag, "%s %s\n", COMMS_RULE, rule.name);
+    fflush(app->comms->toCag);
+}
+
 void handle_halp() {
     char* mds = "\x0D\x0A\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20"
     "\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20\x20"